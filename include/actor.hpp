@@ -191,12 +191,10 @@ public:
         return data_->is_humanoid;
     }
 
-    void add_light(bool light_map[map_w][map_h]) const;
+    // Registers any light emitted by the actor (see "light_srcs")
+    void add_light() const;
 
-    virtual void add_light_hook(bool light[map_w][map_h]) const
-    {
-        (void)light;
-    }
+    virtual void add_light_hook() const {}
 
     void teleport();
 
@@ -222,9 +220,16 @@ public:
 
     bool is_player() const;
 
+    // NOTE: The position must only be changed through "set_pos" once the actor
+    //       has been added to the actor list, to keep per-cell lookups in sync
     P pos;
 
-    int delay_;
+    void set_pos(const P& p);
+
+    // Set by game_time - the absolute tick on which the actor acts next, and
+    // the order in which actors acting on the same tick take their turns
+    int nxt_act_tick_;
+    int act_order_;
 
 protected:
     // TODO: Try to get rid of these friend declarations
@@ -0,0 +1,99 @@
+#ifndef ANIMATION_HPP
+#define ANIMATION_HPP
+
+#include <vector>
+
+#include "rl_utils.hpp"
+#include "colors.hpp"
+#include "art.hpp"
+
+// Animations (projectiles, explosions, etc) are not drawn while the game
+// logic runs. Instead, the logic records what should be shown into a script,
+// which is played back afterwards on top of the current game state.
+//
+// NOTE: Recording is skipped entirely if nothing would be shown anyway (no
+//       io, or the bot is playing), so scripts cost nothing in that case.
+
+struct AnimCell
+{
+    AnimCell(const P& pos_,
+             const TileId tile_,
+             const char glyph_,
+             const Clr& clr_) :
+        pos     (pos_),
+        tile    (tile_),
+        glyph   (glyph_),
+        clr     (clr_) {}
+
+    P pos;
+    TileId tile;
+    char glyph;
+    Clr clr;
+};
+
+struct AnimFrame
+{
+    AnimFrame(const int duration_, const bool draw_map_before_) :
+        cells           (),
+        duration        (duration_),
+        draw_map_before (draw_map_before_) {}
+
+    std::vector<AnimCell> cells;
+
+    // Milliseconds
+    int duration;
+
+    // If false, the frame is drawn on top of the previous frame (trails)
+    bool draw_map_before;
+};
+
+class AnimScript
+{
+public:
+    AnimScript();
+
+    bool is_recording() const
+    {
+        return is_recording_;
+    }
+
+    bool is_empty() const
+    {
+        return frames_.empty();
+    }
+
+    const std::vector<AnimFrame>& frames() const
+    {
+        return frames_;
+    }
+
+    void add_frame(const int duration, const bool draw_map_before = true);
+
+    // Adds a cell to the last added frame
+    void add_cell(const P& pos,
+                  const TileId tile,
+                  const char glyph,
+                  const Clr& clr);
+
+    // Adds the standard two step blast animation over the given cells
+    void add_blast(const std::vector<P>& positions,
+                   const Clr& clr,
+                   const int duration);
+
+private:
+    std::vector<AnimFrame> frames_;
+
+    const bool is_recording_;
+};
+
+namespace anim
+{
+
+bool is_enabled();
+
+// Plays the frames in order, pressing any key skips the rest of the script
+void play(const AnimScript& script);
+
+} // anim
+
+#endif // ANIMATION_HPP
@@ -0,0 +1,19 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <ostream>
+
+//
+// Micro benchmarks of performance critical game routines, compared against
+// the simpler (original) way of computing the same thing. Run through the
+// headless simulator ("ia-sim --bench"), so they never slow down the tests.
+//
+
+namespace bench
+{
+
+void run(std::ostream& out);
+
+} // bench
+
+#endif // BENCH_HPP
@@ -17,6 +17,7 @@ bool is_tiles_mode();
 std::string font_name();
 bool use_light_fade_effect();
 bool is_fullscreen();
+bool is_gpu_rendering();
 int scr_px_w();
 int scr_px_h();
 int cell_px_w();
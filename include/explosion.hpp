@@ -33,6 +33,28 @@ enum class ExplExclCenter
     yes
 };
 
+struct ExplCell
+{
+    P pos;
+    int dist;
+};
+
+// The cells reached by an explosion, ordered by distance from the origin (and
+// from top left to bottom right for each distance). The buffer is filled by
+// "cells_reached", which reuses its capacity - so it can be kept around by the
+// caller between explosions.
+struct ExplReach
+{
+    ExplReach() :
+        cells       (),
+        nr_dists    (0) {}
+
+    std::vector<ExplCell> cells;
+
+    // The furthest distance reached plus one (zero if no cell was reached)
+    int nr_dists;
+};
+
 namespace explosion
 {
 
@@ -54,6 +76,15 @@ void run_smoke_explosion_at(const P& origin,
 R explosion_area(const P& c,
                  const int radi);
 
+// Finds the cells in the area which the explosion reaches from the origin, a
+// cell is reached if no cell on the line from the origin to it is blocked
+// (adjacent cells are always reached)
+void cells_reached(const R& area,
+                   const P& origin,
+                   const ExplExclCenter exclude_center,
+                   const bool blocked[map_w][map_h],
+                   ExplReach& out);
+
 } // explosion
 
 #endif
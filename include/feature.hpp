@@ -51,7 +51,11 @@ public:
 
     int shock_when_adj() const;
 
-    virtual void add_light(bool light[map_w][map_h]) const;
+    // The light currently emitted by the feature (see "light_srcs")
+    virtual LgtSize lgt_size() const
+    {
+        return LgtSize::none;
+    }
 
     P pos() const
     {
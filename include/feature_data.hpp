@@ -1,6 +1,7 @@
 #ifndef FEATURE_DATA_HPP
 #define FEATURE_DATA_HPP
 
+#include <cstdint>
 #include <functional>
 #include "art.hpp"
 #include "map_patterns.hpp"
@@ -115,6 +116,9 @@ struct FeatureDataT
     bool can_have_rigid;
     bool can_have_item;
     bool is_bottomless;
+    // The feature object overrides the passability checks depending on its
+    // current state (e.g. doors being open or closed)
+    bool is_passability_dynamic;
     Matl matl_type;
     std::string msg_on_player_blocked;
     std::string msg_on_player_blocked_blind;
@@ -123,13 +127,38 @@ struct FeatureDataT
     FeaturePlacement auto_spawn_placement;
 };
 
+// Blocking flags precomputed per feature id from the data list (used by the
+// map parsers to avoid going through the feature objects)
+namespace feature_flag
+{
+
+const uint8_t blocks_los            = 1 << 0;
+const uint8_t blocks_move_common    = 1 << 1;
+const uint8_t blocks_projectiles    = 1 << 2;
+const uint8_t blocks_items          = 1 << 3;
+const uint8_t blocks_rigid          = 1 << 4;
+const uint8_t blocks_sound          = 1 << 5;
+
+// NOTE: If this is set, the other flags only describe the default state, and
+//       the feature object must be asked instead
+const uint8_t dynamic               = 1 << 7;
+
+} // feature_flag
+
 namespace feature_data
 {
 
+extern uint8_t flags_list[(size_t)FeatureId::END];
+
 void init();
 
 const FeatureDataT& data(const FeatureId id);
 
+inline uint8_t flags(const FeatureId id)
+{
+    return flags_list[(size_t)id];
+}
+
 } // feature_data
 
 #endif
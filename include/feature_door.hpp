@@ -115,19 +115,9 @@ public:
 
     void reveal(const Verbosity verbosity) override;
 
-    void set_secret()
-    {
-        ASSERT(type_ != DoorType::gate);
-
-        is_open_ = false;
-        is_secret_ = true;
-    }
+    void set_secret();
 
-    void set_stuck()
-    {
-        is_open_ = false;
-        is_stuck_ = true;
-    }
+    void set_stuck();
 
     DidOpen open(Actor* const actor_opening) override;
 
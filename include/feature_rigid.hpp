@@ -106,7 +106,7 @@ public:
         (void)lever;
     }
 
-    void add_light(bool light[map_w][map_h]) const override final;
+    LgtSize lgt_size() const override final;
 
     void mk_bloody()
     {
@@ -115,7 +115,7 @@ public:
 
     void set_has_burned()
     {
-        burn_state_ = BurnState::has_burned;
+        set_burn_state(BurnState::has_burned);
     }
 
     BurnState burn_state() const
@@ -148,17 +148,23 @@ protected:
 
     virtual DidTriggerTrap trigger_trap(Actor* const actor);
 
-    virtual void add_light_hook(bool light[map_w][map_h]) const
+    virtual LgtSize lgt_size_hook() const
     {
-        (void)light;
+        return LgtSize::none;
     }
 
+    // Must be called after any change which may affect the light emitted by
+    // the rigid, with the light emitted before the change
+    void on_lgt_changed(const LgtSize lgt_before);
+
     virtual int base_shock_when_adj() const;
 
     TileId gore_tile_;
     char gore_glyph_;
 
 private:
+    void set_burn_state(const BurnState state);
+
     bool is_bloody_;
     BurnState burn_state_;
 
@@ -395,7 +401,7 @@ private:
                 const DmgMethod dmg_method,
                 Actor* const actor) override;
 
-    void add_light_hook(bool light[map_w][map_h]) const override;
+    LgtSize lgt_size_hook() const override;
 };
 
 enum class WallType
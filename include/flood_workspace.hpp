@@ -0,0 +1,78 @@
+#ifndef FLOOD_WORKSPACE_HPP
+#define FLOOD_WORKSPACE_HPP
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "rl_utils.hpp"
+#include "global.hpp"
+
+// Reusable buffers for flood fills and pathfinding over the map.
+//
+// Each cell stores the number of the fill which last reached it, so nothing
+// needs to be cleared between fills - only the cells actually reached are
+// written. Fills can be limited by distance, and to an area of the map.
+//
+// NOTE: A workspace only holds the result of the latest fill, so callers must
+//       be careful not to start a new fill (e.g. through some nested call)
+//       while still reading the results of a previous one.
+class FloodWorkspace
+{
+public:
+    FloodWorkspace();
+
+    FloodWorkspace(const FloodWorkspace&) = delete;
+    FloodWorkspace& operator=(const FloodWorkspace&) = delete;
+
+    // Fills outwards from the origin through cells which are not blocked,
+    // inside the given area, up to the given number of steps. If a target is
+    // given, the fill stops when the target is reached - the target is always
+    // entered, even if it is blocked.
+    void run(const P& origin,
+             const bool blocked[map_w][map_h],
+             const int max_dist = INT_MAX,
+             const bool allow_diagonal = true,
+             const R& area = R(1, 1, map_w - 2, map_h - 2),
+             const P& tgt = P(-1, -1));
+
+    bool is_reached(const P& p) const
+    {
+        return stamp_[p.x][p.y] == stamp_nr_;
+    }
+
+    // Number of steps from the origin, or zero if not reached (the same as
+    // the "floodfill" output)
+    int dist(const P& p) const
+    {
+        return is_reached(p) ? dist_[p.x][p.y] : 0;
+    }
+
+    // All reached cells, in order of distance (starting with the origin)
+    const std::vector<P>& reached() const
+    {
+        return reached_;
+    }
+
+    // Finds a shortest path from p0 to p1. The path is stored in the same way
+    // as by "pathfind": from p1 (first element) back to the cell next to p0,
+    // and p0 itself is not included. The path is empty if p1 is unreachable.
+    void pathfind(const P& p0,
+                  const P& p1,
+                  const bool blocked[map_w][map_h],
+                  std::vector<P>& out,
+                  const bool allow_diagonal = true,
+                  const bool randomize_steps = true);
+
+private:
+    void begin_fill();
+
+    uint32_t stamp_nr_;
+    uint32_t stamp_[map_w][map_h];
+    int dist_[map_w][map_h];
+
+    // Doubles as the queue of the breadth first search
+    std::vector<P> reached_;
+};
+
+#endif // FLOOD_WORKSPACE_HPP
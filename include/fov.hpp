@@ -17,6 +17,8 @@ struct LosResult
 namespace fov
 {
 
+void init();
+
 R get_fov_rect(const P& p);
 
 bool is_in_fov_range(const P& p0, const P& p1);
@@ -25,6 +27,7 @@ LosResult check_cell(const P& p0,
                       const P& p1,
                       const bool hard_blocked[map_w][map_h]);
 
+// Sets the same result for each cell in the FOV rect as "check_cell" would
 void run(const P& p0,
          const bool hard_blocked[map_w][map_h],
          LosResult out[map_w][map_h]);
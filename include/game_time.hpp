@@ -24,6 +24,9 @@ void load();
 
 void add_actor(Actor* actor);
 
+// Removes the actor from the actor list and the schedule, and deletes it
+void erase_actor(Actor* const actor);
+
 void tick(const int speed_pct_diff = 0);
 
 int turn_nr();
@@ -32,14 +35,21 @@ Actor* current_actor();
 
 void mobs_at_pos(const P& pos, std::vector<Mob*>& vector_ref);
 
+// The mobs, and the actors (of any state) in the given cell
+const std::vector<Mob*>& mobs_at_pos(const P& pos);
+
+const std::vector<Actor*>& actors_at_pos(const P& pos);
+
+// Must be called whenever the position of an actor changes (this is handled by
+// Actor::set_pos)
+void on_actor_moved(Actor* const actor, const P& old_pos);
+
 void add_mob(Mob* const f);
 
 void erase_mob(Mob* const f, const bool destroy_object);
 
 void erase_all_mobs();
 
-void reset_turn_type_and_actor_counters();
-
 void update_light_map();
 
 } // game_time
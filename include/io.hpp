@@ -11,8 +11,6 @@
 #include "config.hpp"
 #include "art.hpp"
 
-struct Projectile;
-
 enum class Panel
 {
     screen,
@@ -45,10 +43,19 @@ namespace io
 void init();
 void cleanup();
 
+// False when running headless (e.g. batch simulations and tests)
+bool is_inited();
+
 void update_screen();
 
 void clear_screen();
 
+// Requests the whole screen to be redrawn (cleared, and all states drawn). The
+// redraw is deferred until something else is about to be drawn, or the screen
+// is presented, so several requests in a row only cost one redraw. Clearing
+// the screen cancels the request.
+void request_redraw();
+
 void draw_tile(const TileId tile,
                const Panel panel,
                const P& pos,
@@ -121,9 +128,6 @@ void draw_main_menu_logo(const int y_pos);
 
 void draw_skull(const P& p);
 
-void draw_projectiles(std::vector<Projectile*>& projectiles,
-                      const bool draw_map_before);
-
 void draw_box(const R& area,
               const Panel panel = Panel::screen,
               const Clr& clr = clr_gray_drk,
@@ -0,0 +1,39 @@
+#ifndef LIGHT_SRCS_HPP
+#define LIGHT_SRCS_HPP
+
+#include "rl_utils.hpp"
+#include "global.hpp"
+
+// Registry of all light sources on the map, used for keeping the light map
+// (the "is_lit" flag of the map cells) up to date. Sources are kept by their
+// origin and size, and the light map is only recalculated where a source was
+// added, moved or removed, or where the terrain blocking the light of a source
+// has changed.
+namespace light_srcs
+{
+
+// Forgets all light sources, must be called when the light map is reset
+void reset();
+
+// Sources which stay in place (burning or lit features, flares) register
+// themselves when they start emitting light, and unregister when they stop
+void add(const P& origin, const LgtSize size);
+
+void remove(const P& origin, const LgtSize size);
+
+// Must be called when something blocking light was added or removed at the
+// given position (the FOV sized sources in range are recalculated)
+void on_los_blocking_changed(const P& p);
+
+// Sources which may move or change on any turn (i.e. actors) are instead
+// collected on each update (see game_time::update_light_map), by calling
+// "add_moving" between these two calls. The light map is updated at the end.
+void begin_update();
+
+void add_moving(const P& origin, const LgtSize size);
+
+void end_update();
+
+} // light_srcs
+
+#endif // LIGHT_SRCS_HPP
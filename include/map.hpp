@@ -15,19 +15,67 @@
 class Rigid;
 class Mob;
 
+// The cell data is stored as one array per field ("planes"), so that passes
+// over the whole map only stream over the fields they actually use, instead of
+// striding over full cell structs. Cells can still be accessed as a whole via
+// "map::cells[x][y]" (see below).
+struct CellPlanes
+{
+    CellPlanes();
+    ~CellPlanes();
+
+    bool is_explored[map_w][map_h];
+    bool is_seen_by_player[map_w][map_h];
+    bool is_lit[map_w][map_h];
+    bool is_dark[map_w][map_h];
+    LosResult player_los[map_w][map_h]; // Updated when player updates FOV
+    Item* item[map_w][map_h];
+    Rigid* rigid[map_w][map_h];
+    CellRenderData player_visual_memory[map_w][map_h];
+};
+
+// A view of the fields of one cell in the planes - this is cheap to create and
+// copy, and writing to the fields writes to the map
 struct Cell
 {
-    Cell();
-    ~Cell();
+    Cell(const int x, const int y);
 
     void reset();
 
-    bool is_explored, is_seen_by_player, is_lit, is_dark;
-    LosResult player_los; // Updated when player updates FOV
-    Item* item;
-    Rigid* rigid;
-    CellRenderData player_visual_memory;
-    P pos;
+    bool& is_explored;
+    bool& is_seen_by_player;
+    bool& is_lit;
+    bool& is_dark;
+    LosResult& player_los;
+    Item*& item;
+    Rigid*& rigid;
+    CellRenderData& player_visual_memory;
+    const P pos;
+};
+
+// Indexed like a two dimensional array of cells, i.e. "cells[x][y]"
+class CellGrid
+{
+public:
+    class Column
+    {
+    public:
+        Column(const int x) :
+            x_(x) {}
+
+        Cell operator[](const int y) const
+        {
+            return Cell(x_, y);
+        }
+
+    private:
+        const int x_;
+    };
+
+    Column operator[](const int x) const
+    {
+        return Column(x);
+    }
 };
 
 enum class MapType
@@ -76,7 +124,14 @@ extern Player* player;
 
 extern int dlvl;
 
-extern Cell cells[map_w][map_h];
+extern CellPlanes cell_planes;
+
+extern const CellGrid cells;
+
+// The blocking properties of the rigid in each cell, as "feature_flag" bits.
+// This is kept up to date by "put" and "on_terrain_changed", so the hot loops
+// do not need to ask the rigids.
+extern uint8_t terrain_flags[map_w][map_h];
 
 extern Clr wall_clr;
 
@@ -100,6 +155,20 @@ void reset_map();
 
 Rigid* put(Rigid* const rigid);
 
+// Increased whenever the terrain changes in a way which may affect movement
+// (features being put on the map, doors opening or closing). This allows
+// caching data derived from the terrain.
+int terrain_revision();
+
+// Must be called when the rigid at the given position changes state in a way
+// which affects its blocking properties (e.g. a door opening)
+void on_terrain_changed(const P& p);
+
+inline bool terrain_blocks(const P& p, const uint8_t flag)
+{
+    return terrain_flags[p.x][p.y] & flag;
+}
+
 // This should be called when e.g. a door closes, or a wall is destoyed -
 // updates light map, player fov (etc).
 void update_vision();
@@ -127,4 +196,15 @@ bool is_area_inside_map(const R& area);
 
 } // map
 
+inline Cell::Cell(const int x, const int y) :
+    is_explored             (map::cell_planes.is_explored[x][y]),
+    is_seen_by_player       (map::cell_planes.is_seen_by_player[x][y]),
+    is_lit                  (map::cell_planes.is_lit[x][y]),
+    is_dark                 (map::cell_planes.is_dark[x][y]),
+    player_los              (map::cell_planes.player_los[x][y]),
+    item                    (map::cell_planes.item[x][y]),
+    rigid                   (map::cell_planes.rigid[x][y]),
+    player_visual_memory    (map::cell_planes.player_visual_memory[x][y]),
+    pos                     (x, y) {}
+
 #endif // MAP_HPP
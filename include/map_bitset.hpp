@@ -0,0 +1,68 @@
+#ifndef MAP_BITSET_HPP
+#define MAP_BITSET_HPP
+
+#include <cstdint>
+
+#include "rl_utils.hpp"
+#include "global.hpp"
+
+// A packed boolean map layer, with one 32 bit word per map column (bit "y" of
+// column "x" is the value for the cell at x, y). This is used instead of bool
+// arrays where whole layers are combined, expanded, or counted - each operation
+// works on entire columns at once, in plain loops over the columns which the
+// compiler can vectorize.
+class MapBitset
+{
+public:
+    MapBitset();
+
+    explicit MapBitset(const bool in[map_w][map_h]);
+
+    // Only reads the cells within the area, all other cells are cleared
+    MapBitset(const bool in[map_w][map_h], const R& area);
+
+    void to_array(bool out[map_w][map_h]) const;
+
+    bool at(const P& p) const
+    {
+        return (cols_[p.x] >> p.y) & 1u;
+    }
+
+    void set(const P& p, const bool v = true)
+    {
+        const uint32_t bit = uint32_t(1) << p.y;
+
+        cols_[p.x] = v ? (cols_[p.x] | bit) : (cols_[p.x] & ~bit);
+    }
+
+    void clear();
+
+    // Clears all cells within the area
+    void clear(const R& area);
+
+    int count() const;
+
+    bool any() const;
+
+    MapBitset& operator|=(const MapBitset& other);
+    MapBitset& operator&=(const MapBitset& other);
+
+    MapBitset operator|(const MapBitset& other) const;
+    MapBitset operator&(const MapBitset& other) const;
+    MapBitset operator~() const;
+
+    bool operator==(const MapBitset& other) const;
+    bool operator!=(const MapBitset& other) const;
+
+    // Returns a layer where all cells within the given (king) distance of any
+    // set cell are set
+    MapBitset expanded(const int dist) const;
+
+private:
+    // Mask for the bits within the map height
+    static const uint32_t col_mask_ = (uint32_t(1) << map_h) - 1;
+
+    uint32_t cols_[map_w];
+};
+
+#endif // MAP_BITSET_HPP
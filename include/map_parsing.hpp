@@ -5,6 +5,7 @@
 
 #include "config.hpp"
 #include "feature_data.hpp"
+#include "map_bitset.hpp"
 
 struct Cell;
 class Mob;
@@ -51,6 +52,10 @@ public:
              const MapParseMode write_rule = MapParseMode::overwrite,
              const R& area_to_parse_cells = R(0, 0, map_w - 1, map_h - 1));
 
+    void run(MapBitset& out,
+             const MapParseMode write_rule = MapParseMode::overwrite,
+             const R& area_to_parse_cells = R(0, 0, map_w - 1, map_h - 1));
+
     bool cell(const P& p);
 
     virtual bool parse(const Cell& c) const
@@ -83,36 +88,68 @@ protected:
         parse_actors_   (parse_actors) {}
 
 private:
+    template<typename Out>
+    void run_impl(Out& out,
+                  const MapParseMode write_rule,
+                  const R& area_to_parse_cells);
+
     const ParseCells parse_cells_;
     const ParseMobs parse_mobs_;
     const ParseActors parse_actors_;
 };
 
-class BlocksLos : public MapParser
+// -----------------------------------------------------------------------------
+// Static map parsers
+// -----------------------------------------------------------------------------
+// Same interface as MapParser, but the predicate is bound at compile time, so
+// the test is inlined into the parsing loops instead of being a virtual call
+// per cell. The predicates are defined (and the parsers instantiated) in
+// map_parsing.cpp, where they read the precomputed feature flag tables.
+struct BlocksLosPred;
+struct BlocksMoveCommonPred;
+struct BlocksProjectilesPred;
+struct BlocksItemsPred;
+struct BlocksRigidPred;
+
+template<typename Pred>
+class StaticMapParser
 {
 public:
-    BlocksLos() :
-        MapParser(ParseCells::yes,
-                  ParseMobs::yes,
-                  ParseActors::no) {}
+    void run(bool out[map_w][map_h],
+             const MapParseMode write_rule = MapParseMode::overwrite,
+             const R& area_to_parse_cells = R(0, 0, map_w - 1, map_h - 1));
+
+    void run(MapBitset& out,
+             const MapParseMode write_rule = MapParseMode::overwrite,
+             const R& area_to_parse_cells = R(0, 0, map_w - 1, map_h - 1));
+
+    bool cell(const P& p);
+
+protected:
+    StaticMapParser(ParseActors parse_actors) :
+        parse_actors_(parse_actors) {}
 
 private:
-    bool parse(const Cell& c) const override;
-    bool parse(const Mob& f) const override;
+    template<typename Out>
+    void run_impl(Out& out,
+                  const MapParseMode write_rule,
+                  const R& area_to_parse_cells);
+
+    const ParseActors parse_actors_;
 };
 
-class BlocksMoveCommon : public MapParser
+class BlocksLos : public StaticMapParser<BlocksLosPred>
 {
 public:
-    BlocksMoveCommon(ParseActors parse_actors) :
-        MapParser(ParseCells::yes,
-                  ParseMobs::yes,
-                  parse_actors) {}
+    BlocksLos() :
+        StaticMapParser(ParseActors::no) {}
+};
 
-private:
-    bool parse(const Cell& c) const override;
-    bool parse(const Mob& f) const override;
-    bool parse(const Actor& a) const override;
+class BlocksMoveCommon : public StaticMapParser<BlocksMoveCommonPred>
+{
+public:
+    BlocksMoveCommon(ParseActors parse_actors) :
+        StaticMapParser(parse_actors) {}
 };
 
 class BlocksActor : public MapParser
@@ -132,17 +169,11 @@ private:
     Actor& actor_;
 };
 
-class BlocksProjectiles : public MapParser
+class BlocksProjectiles : public StaticMapParser<BlocksProjectilesPred>
 {
 public:
     BlocksProjectiles() :
-        MapParser(ParseCells::yes,
-                  ParseMobs::yes,
-                  ParseActors::no) {}
-
-private:
-    bool parse(const Cell& c) const override;
-    bool parse(const Mob& f) const override;
+        StaticMapParser(ParseActors::no) {}
 };
 
 class LivingActorsAdjToPos : public MapParser
@@ -160,29 +191,18 @@ private:
     const P& pos_;
 };
 
-class BlocksItems : public MapParser
+class BlocksItems : public StaticMapParser<BlocksItemsPred>
 {
 public:
     BlocksItems() :
-        MapParser(ParseCells::yes,
-                  ParseMobs::yes,
-                  ParseActors::no) {}
-
-private:
-    bool parse(const Cell& c) const override;
-    bool parse(const Mob& f) const override;
+        StaticMapParser(ParseActors::no) {}
 };
 
-class BlocksRigid : public MapParser
+class BlocksRigid : public StaticMapParser<BlocksRigidPred>
 {
 public:
     BlocksRigid() :
-        MapParser(ParseCells::yes,
-                  ParseMobs::no,
-                  ParseActors::no) {}
-
-private:
-    bool parse(const Cell& c) const override;
+        StaticMapParser(ParseActors::no) {}
 };
 
 class IsFeature : public MapParser
@@ -320,6 +340,10 @@ void cells_within_dist_of_others(const bool in[map_w][map_h],
                                  bool out[map_w][map_h],
                                  const Range& dist_interval);
 
+void cells_within_dist_of_others(const MapBitset& in,
+                                 MapBitset& out,
+                                 const Range& dist_interval);
+
 void append(bool base[map_w][map_h],
             const bool append[map_w][map_h]);
 
@@ -328,7 +352,6 @@ void expand(const bool in[map_w][map_h],
             bool out[map_w][map_h],
             const R& area_allowed_to_modify = R(0, 0, map_w - 1, map_h - 1));
 
-// Slower version that can expand any distance
 void expand(const bool in[map_w][map_h],
             bool out[map_w][map_h],
             const int dist);
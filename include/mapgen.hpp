@@ -107,6 +107,8 @@ void mk_floor(const Room& room);
 //------------------------------------------------------------------------------
 // Misc utils
 //------------------------------------------------------------------------------
+bool is_all_rooms_connected();
+
 void valid_corridor_entries(const Room& room,
                             std::vector<P>& out);
 
@@ -114,9 +116,18 @@ bool is_choke_point(const P& p,
                     const bool blocked[map_w][map_h],
                     ChokePointData& out);
 
+// Finds all choke points (as defined by "is_choke_point") among the candidate
+// positions, with a single search over the map instead of flood fills for each
+// candidate. The player and stairs sides are not set.
+void find_choke_points(const bool blocked[map_w][map_h],
+                       const bool candidates[map_w][map_h],
+                       std::vector<ChokePointData>& out);
+
+// If "carved_out" is set, the cells where floor was put are appended to it
 void mk_pathfind_corridor(Room& r0,
                           Room& r1,
-                          bool door_proposals[map_w][map_h] = nullptr);
+                          bool door_proposals[map_w][map_h] = nullptr,
+                          std::vector<P>* const carved_out = nullptr);
 
 void rnd_walk(const P& p0,
               int len,
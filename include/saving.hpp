@@ -1,6 +1,7 @@
 #ifndef SAVE_HANDLING_HPP
 #define SAVE_HANDLING_HPP
 
+#include <cstddef>
 #include <string>
 
 namespace saving
@@ -9,7 +10,12 @@ namespace saving
 void init();
 
 void save_game();
-void load_game();
+
+// Returns false if the save file could not be read, or if it is corrupted (or
+// written by another version of the game) - the save file is then left as it
+// is, and the game state may be partially loaded (the session should be
+// cleaned up)
+bool load_game();
 
 bool is_save_available();
 
@@ -18,10 +24,18 @@ void put_str(const std::string str);
 void put_int(const int v);
 void put_bool(const bool v);
 
+//Arrays are stored as one length-prefixed block, and must be read back with
+//the same number of elements.
+void put_int_arr(const int* const arr, const size_t nr_elements);
+void put_bool_arr(const bool* const arr, const size_t nr_elements);
+
 std::string get_str();
 int         get_int();
 bool        get_bool();
 
+void get_int_arr(int* const arr, const size_t nr_elements);
+void get_bool_arr(bool* const arr, const size_t nr_elements);
+
 } //saving
 
 #endif
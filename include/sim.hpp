@@ -0,0 +1,113 @@
+#ifndef SIM_HPP
+#define SIM_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "global.hpp"
+
+//
+// Headless batch simulation - plays complete games with the bot, without any
+// window, audio, or rendering (the io, audio and sdl_base modules are simply
+// never initialized). Used for soak testing and performance measurements.
+//
+// NOTE: All game state is global (including the random number generator), so
+//       only one game can run per process. Runs are spread over multiple cores
+//       by launching worker processes, each running a share of the games and
+//       writing its results to the parent, which merges them in one report.
+//
+
+enum class SimPhase
+{
+    setup,          // Session init, character creation and the first level
+    player,         // Bot actions (excluding level transitions)
+    mon,            // Monster actions (excluding level transitions)
+    lvl_transition, // Any action during which the player changed level
+    END
+};
+
+enum class SimResult
+{
+    reached_max_dlvl,
+    died,
+    turn_limit
+};
+
+struct SimParams
+{
+    SimParams() :
+        seed        (1),
+        nr_runs     (1),
+        max_dlvl    (dlvl_last),
+        max_turns   (100000),
+        nr_jobs     (1) {}
+
+    // Each run is seeded with this seed plus the index of the run
+    unsigned int seed;
+
+    int nr_runs;
+
+    // A run is finished when reaching this level (constrained to dlvl_last)
+    int max_dlvl;
+
+    // Runs taking longer than this are aborted (to bound stuck bots)
+    int max_turns;
+
+    // Number of worker processes to spread the runs over
+    int nr_jobs;
+};
+
+struct SimRunData
+{
+    SimRunData() :
+        seed        (0),
+        result      (SimResult::turn_limit),
+        dlvl        (0),
+        nr_turns    (0),
+        phase_ms    () {}
+
+    unsigned int seed;
+    SimResult result;
+    int dlvl;
+    int nr_turns;
+    double phase_ms[(size_t)SimPhase::END];
+};
+
+struct SimReport
+{
+    SimReport() :
+        runs        (),
+        nr_runs_lost(0),
+        total_ms    (0.0) {}
+
+    std::vector<SimRunData> runs;
+
+    // Runs which never reported back (i.e. the worker process crashed)
+    int nr_runs_lost;
+
+    // Wall clock time for all runs
+    double total_ms;
+};
+
+namespace sim
+{
+
+// NOTE: init::init_game() must have been called before running simulations
+SimRunData run_one(const unsigned int seed, const SimParams& params);
+
+SimReport run(const SimParams& params);
+
+// Splits the runs over "params.nr_jobs" worker processes, launched by running
+// "worker_exe" (i.e. "ia-sim --worker [first seed] [nr runs] [max dlvl]")
+SimReport run_parallel(const SimParams& params, const std::string& worker_exe);
+
+// Used for passing results from worker processes to the parent
+void write_run_data(const SimRunData& d, std::ostream& out);
+bool read_run_data(const std::string& line, SimRunData& d);
+
+void print_report(const SimReport& report, std::ostream& out);
+
+} // sim
+
+#endif // SIM_HPP
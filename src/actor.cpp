@@ -22,10 +22,12 @@
 #include "popup.hpp"
 #include "feature_door.hpp"
 #include "text_format.hpp"
+#include "light_srcs.hpp"
 
 Actor::Actor() :
     pos             (),
-    delay_          (0),
+    nxt_act_tick_   (0),
+    act_order_      (0),
     state_          (ActorState::alive),
     hp_             (-1),
     hp_max_         (-1),
@@ -184,6 +186,15 @@ int Actor::speed_pct() const
     return speed;
 }
 
+void Actor::set_pos(const P& p)
+{
+    const P old_pos = pos;
+
+    pos = p;
+
+    game_time::on_actor_moved(this, old_pos);
+}
+
 void Actor::place(const P& pos_, ActorDataT& actor_data)
 {
     pos = pos_;
@@ -436,7 +447,7 @@ void Actor::teleport(P p, bool blocked[map_w][map_h])
     }
 
     // Update actor position to new position
-    pos = p;
+    set_pos(p);
 
     map::update_vision();
 
@@ -1121,7 +1132,7 @@ void Actor::die(const bool is_destroyed,
 
                         if (feature_here->can_have_corpse())
                         {
-                            pos.set(new_pos);
+                            set_pos(new_pos);
                             dx = 9999;
                             dy = 9999;
                         }
@@ -1303,50 +1314,19 @@ void Actor::on_feed()
     }
 }
 
-void Actor::add_light(bool light_map[map_w][map_h]) const
+void Actor::add_light() const
 {
     if (state_ == ActorState::alive &&
         prop_handler_->has_prop(PropId::radiant))
     {
-        // TODO: Much of the code below is duplicated from
-        // ActorPlayer::add_light_hook(), some refactoring is needed.
-
-        bool hard_blocked[map_w][map_h];
-
-         const R fov_lmt = fov::get_fov_rect(pos);
-
-        map_parsers::BlocksLos()
-            .run(hard_blocked,
-                 MapParseMode::overwrite,
-                 fov_lmt);
-
-        LosResult fov[map_w][map_h];
-
-        fov::run(pos, hard_blocked, fov);
-
-        for (int y = fov_lmt.p0.y; y <= fov_lmt.p1.y; ++y)
-        {
-            for (int x = fov_lmt.p0.x; x <= fov_lmt.p1.x; ++x)
-            {
-                if (!fov[x][y].is_blocked_hard)
-                {
-                    light_map[x][y] = true;
-                }
-            }
-        }
+        light_srcs::add_moving(pos, LgtSize::fov);
     }
     else if (prop_handler_->has_prop(PropId::burning))
     {
-        for (int dx = -1; dx <= 1; ++dx)
-        {
-            for (int dy = -1; dy <= 1; ++dy)
-            {
-                light_map[pos.x + dx][pos.y + dy] = true;
-            }
-        }
+        light_srcs::add_moving(pos, LgtSize::small);
     }
 
-    add_light_hook(light_map);
+    add_light_hook();
 }
 
 bool Actor::is_player() const
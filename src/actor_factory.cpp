@@ -276,21 +276,14 @@ Actor* mk(const ActorId id, const P& pos)
 
 void delete_all_mon()
 {
-    std::vector<Actor*>& actors = game_time::actors;
+    // NOTE: Iterating over a copy, since the actors are erased from the list
+    const std::vector<Actor*> actors_cpy = game_time::actors;
 
-    for (auto it = begin(actors); it != end(actors); /* No increment */)
+    for (Actor* const actor : actors_cpy)
     {
-        Actor* const actor = *it;
-
-        if (actor == map::player)
-        {
-            ++it;
-        }
-        else // Is monster
+        if (actor != map::player)
         {
-            delete actor;
-
-            it = actors.erase(it);
+            game_time::erase_actor(actor);
         }
     }
 }
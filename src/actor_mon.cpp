@@ -598,7 +598,7 @@ void Mon::move(Dir dir)
 
     if (dir != Dir::center && map::is_pos_inside_map(tgt_p, false))
     {
-        pos = tgt_p;
+        set_pos(tgt_p);
 
         // Bump features in target cell (i.e. to trigger traps)
         std::vector<Mob*> mobs;
@@ -37,6 +37,7 @@
 #include "saving.hpp"
 #include "insanity.hpp"
 #include "reload.hpp"
+#include "light_srcs.hpp"
 
 Player::Player() :
     Actor(),
@@ -329,8 +330,11 @@ void Player::load()
     hp_max_ = saving::get_int();
     spi_ = saving::get_int();
     spi_max_ = saving::get_int();
-    pos.x = saving::get_int();
-    pos.y = saving::get_int();
+    const int pos_x = saving::get_int();
+    const int pos_y = saving::get_int();
+
+    set_pos(P(pos_x, pos_y));
+
     nr_turns_until_rspell_ = saving::get_int();
 
     ItemId unarmed_wpn_id = ItemId(saving::get_int());
@@ -1294,7 +1298,7 @@ void Player::update_tmp_shock()
 
     if (prop_handler_->allow_see())
     {
-        Cell& cell = map::cells[pos.x][pos.y];
+        Cell cell = map::cells[pos.x][pos.y];
 
         // Shock reduction from light?
         if (cell.is_lit)
@@ -1502,7 +1506,7 @@ void Player::on_std_turn()
                     continue;
                 }
 
-                auto& cell = map::cells[x][y];
+                auto cell = map::cells[x][y];
 
                 auto* f = cell.rigid;
 
@@ -1635,7 +1639,7 @@ void Player::move(Dir dir)
     if (dir != Dir::center)
     {
         // Check if map features are blocking (used later)
-        Cell& cell = map::cells[tgt.x][tgt.y];
+        Cell cell = map::cells[tgt.x][tgt.y];
 
         bool is_features_allow_move = cell.rigid->can_move(*this);
 
@@ -1792,10 +1796,10 @@ void Player::move(Dir dir)
                     msg_log::add("I displace " + mon_name + ".");
                 }
 
-                mon->pos = pos;
+                mon->set_pos(pos);
             }
 
-            pos = tgt;
+            set_pos(tgt);
 
             // Walking on item?
             Item* const item = map::cells[pos.x][pos.y].item;
@@ -2008,7 +2012,7 @@ void Player::hand_att(Actor& defender)
     attack::melee(this, pos, defender, wpn);
 }
 
-void Player::add_light_hook(bool light_map[map_w][map_h]) const
+void Player::add_light_hook() const
 {
     LgtSize lgt_size = LgtSize::none;
 
@@ -2033,64 +2037,22 @@ void Player::add_light_hook(bool light_map[map_w][map_h]) const
         }
     }
 
-    switch (lgt_size)
-    {
-    case LgtSize::fov:
-    {
-        bool hard_blocked[map_w][map_h];
-
-         const R fov_lmt = fov::get_fov_rect(pos);
-
-        map_parsers::BlocksLos()
-            .run(hard_blocked,
-                 MapParseMode::overwrite,
-                 fov_lmt);
-
-        LosResult fov[map_w][map_h];
-
-        fov::run(pos, hard_blocked, fov);
-
-        for (int y = fov_lmt.p0.y; y <= fov_lmt.p1.y; ++y)
-        {
-            for (int x = fov_lmt.p0.x; x <= fov_lmt.p1.x; ++x)
-            {
-                if (!fov[x][y].is_blocked_hard)
-                {
-                    light_map[x][y] = true;
-                }
-            }
-        }
-    }
-    break;
-
-    case LgtSize::small:
-        for (int y = pos.y - 1; y <= pos.y + 1; ++y)
-        {
-            for (int x = pos.x - 1; x <= pos.x + 1; ++x)
-            {
-                light_map[x][y] = true;
-            }
-        }
-        break;
-
-    case LgtSize::none:
-        break;
-    }
+    light_srcs::add_moving(pos, lgt_size);
 }
 
 void Player::update_fov()
 {
+    auto& planes = map::cell_planes;
+
     for (int x = 0; x < map_w; ++x)
     {
         for (int y = 0; y < map_h; ++y)
         {
-            Cell& cell = map::cells[x][y];
-
-            cell.is_seen_by_player = false;
+            planes.is_seen_by_player[x][y] = false;
 
-            cell.player_los.is_blocked_hard = true;
+            planes.player_los[x][y].is_blocked_hard = true;
 
-            cell.player_los.is_blocked_by_drk = false;
+            planes.player_los[x][y].is_blocked_by_drk = false;
         }
     }
 
@@ -2115,7 +2077,7 @@ void Player::update_fov()
             {
                 const LosResult& los = fov[x][y];
 
-                Cell& cell = map::cells[x][y];
+                Cell cell = map::cells[x][y];
 
                 cell.is_seen_by_player =
                     !los.is_blocked_hard &&
@@ -2192,7 +2154,7 @@ void Player::update_fov()
                 map_parsers::BlocksMoveCommon(ParseActors::no)
                 .cell(P(x, y));
 
-            Cell& cell = map::cells[x][y];
+            Cell cell = map::cells[x][y];
 
             // Do not explore dark floor cells
             if (cell.is_seen_by_player &&
@@ -2236,7 +2198,7 @@ void Player::fov_hack()
                             (!adj_cell.is_dark || adj_cell.is_lit) &&
                             !blocked[p_adj.x][p_adj.y])
                         {
-                            Cell& cell = map::cells[x][y];
+                            Cell cell = map::cells[x][y];
                             cell.is_seen_by_player = true;
                             cell.player_los.is_blocked_hard = false;
 
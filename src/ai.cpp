@@ -1,5 +1,8 @@
 #include "ai.hpp"
 
+#include <algorithm>
+#include <climits>
+
 #include "actor_player.hpp"
 #include "msg_log.hpp"
 #include "map.hpp"
@@ -10,6 +13,7 @@
 #include "map_parsing.hpp"
 #include "game_time.hpp"
 #include "fov.hpp"
+#include "flood_workspace.hpp"
 
 namespace ai
 {
@@ -524,6 +528,14 @@ bool step_to_lair_if_los(Mon& mon, const P& lair_p)
 namespace info
 {
 
+namespace
+{
+
+// Shared by the monster pathfinding below
+FloodWorkspace path_flood_;
+
+} // namespace
+
 bool look(Mon& mon)
 {
     if (!mon.is_alive())
@@ -619,10 +631,10 @@ void find_path_to_lair_if_no_los(Mon& mon,
             .run(blocked,
                  MapParseMode::append);
 
-        pathfind(mon.pos,
-                 lair_p,
-                 blocked,
-                 path);
+        path_flood_.pathfind(mon.pos,
+                             lair_p,
+                             blocked,
+                             path);
 
         return;
     }
@@ -671,15 +683,175 @@ void find_path_to_leader(Mon& mon, std::vector<P>& path)
         .run(blocked,
              MapParseMode::append);
 
-    pathfind(mon.pos,
-             leader->pos,
-             blocked,
-             path);
+    path_flood_.pathfind(mon.pos,
+                         leader->pos,
+                         blocked,
+                         path);
     return;
 
     path.clear();
 }
 
+namespace
+{
+
+// Monsters path to the player through shared fields of step distances from
+// the player, one per class of monsters with the same movement abilities.
+// A field is rebuilt when the player moves or the terrain changes.
+//
+// NOTE: Which terrain a monster can move through only depends on the
+//       properties below (see the feature move rules, and Door::can_move),
+//       and on whether the monster can open or bash doors.
+const PropId move_class_props_[] =
+{
+    PropId::ethereal,
+    PropId::ooze,
+    PropId::flying,
+    PropId::burrowing
+};
+
+const size_t nr_move_class_props_ =
+    sizeof(move_class_props_) / sizeof(move_class_props_[0]);
+
+const size_t nr_move_classes_ = size_t(1) << (nr_move_class_props_ + 1);
+
+struct DistToPlayerField
+{
+    DistToPlayerField() :
+        is_valid            (false),
+        player_pos          (),
+        terrain_revision    (0) {}
+
+    bool is_valid;
+
+    P player_pos;
+
+    int terrain_revision;
+
+    // Number of steps to the player (zero for unreachable cells)
+    int dist[map_w][map_h];
+};
+
+DistToPlayerField dist_fields_[nr_move_classes_];
+
+size_t move_class(Mon& mon)
+{
+    size_t move_class = 0;
+
+    for (size_t i = 0; i < nr_move_class_props_; ++i)
+    {
+        if (mon.has_prop(move_class_props_[i]))
+        {
+            move_class |= size_t(1) << i;
+        }
+    }
+
+    const ActorDataT& d = mon.data();
+
+    if (d.can_open_doors ||
+        d.can_bash_doors)
+    {
+        move_class |= size_t(1) << nr_move_class_props_;
+    }
+
+    return move_class;
+}
+
+// NOTE: All monsters of the same movement class give the same result here
+void terrain_blocking_mon(Mon& mon, bool blocked[map_w][map_h])
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            blocked[x][y] = true;
+        }
+    }
+
+    for (int x = 1; x < map_w - 1; ++x)
+    {
+        for (int y = 1; y < map_h - 1; ++y)
+        {
+            blocked[x][y] = false;
+
+            const auto* const f = map::cells[x][y].rigid;
+
+            if (f->can_move(mon))
+            {
+                continue;
+            }
+
+            // Doors are only blocked if the monster cannot open or bash
+            if (f->id() == FeatureId::door)
+            {
+                const auto* const door = static_cast<const Door*>(f);
+
+                // Metal doors are always blocking
+                if (door->type() == DoorType::metal)
+                {
+                    blocked[x][y] = true;
+
+                    continue;
+                }
+
+                // Not a metal door
+
+                //
+                // TODO: What if there is a monster that can open
+                //       doors but not bash, and the door is stuck?
+                //
+
+                // Consider non-metal doors as free if monster can open or bash
+                const ActorDataT& d = mon.data();
+
+                if (d.can_open_doors ||
+                    d.can_bash_doors)
+                {
+                    continue;
+                }
+            }
+
+            // Not a door (e.g. a wall)
+            blocked[x][y] = true;
+        }
+    }
+}
+
+// Returns the field for the movement class of the monster, rebuilding it if
+// needed
+const DistToPlayerField& dist_to_player_field(Mon& mon)
+{
+    DistToPlayerField& field = dist_fields_[move_class(mon)];
+
+    const P& player_p = map::player->pos;
+
+    const int terrain_revision = map::terrain_revision();
+
+    if (!field.is_valid ||
+        field.player_pos != player_p ||
+        field.terrain_revision != terrain_revision)
+    {
+        bool blocked[map_w][map_h];
+
+        terrain_blocking_mon(mon, blocked);
+
+        floodfill(player_p,
+                  blocked,
+                  field.dist,
+                  INT_MAX,
+                  P(-1, -1),
+                  true);
+
+        field.is_valid          = true;
+        field.player_pos        = player_p;
+        field.terrain_revision  = terrain_revision;
+    }
+
+    return field;
+}
+
+} // namespace
+
 void find_path_to_player(Mon& mon, std::vector<P>& path)
 {
     if (!mon.is_alive() || mon.aware_of_player_counter_ <= 0)
@@ -730,70 +902,101 @@ void find_path_to_player(Mon& mon, std::vector<P>& path)
     }
 
     // Monster does not have LOS to player - alright, let's go!
+    const auto& dist = dist_to_player_field(mon).dist;
+
+    const P& player_p = map::player->pos;
+
+    // Not possible to reach the player?
+    if (dist[mon.pos.x][mon.pos.y] == 0)
+    {
+        path.clear();
+        return;
+    }
 
-    const int x0 = 1;
-    const int y0 = 1;
-    const int x1 = map_w - 1;
-    const int y1 = map_h - 1;
+    // The first step is the free adjacent cell closest to the player - living
+    // actors next to the monster are stepped around, but only by cells which
+    // are closer to the player than the monster is (never step backwards)
+    const int mon_dist = dist[mon.pos.x][mon.pos.y];
 
-    for (int x = x0; x < x1; ++x)
+    P step(-1, -1);
+
+    int step_dist = mon_dist;
+
+    for (const P& d : dir_utils::dir_list)
     {
-        for (int y = y0; y < y1; ++y)
+        const P p(mon.pos + d);
+
+        if (!map::is_pos_inside_map(p, false))
         {
-            blocked[x][y] = false;
+            continue;
+        }
 
-            const auto* const f = map::cells[x][y].rigid;
+        const int p_dist = dist[p.x][p.y];
 
-            if (f->can_move(mon))
-            {
-                continue;
-            }
+        const bool is_reached = (p_dist > 0) || (p == player_p);
 
-            // Doors are only blocked if the monster cannot open or bash
-            if (f->id() == FeatureId::door)
-            {
-                const auto* const door = static_cast<const Door*>(f);
+        if (!is_reached ||
+            p_dist >= step_dist ||
+            (p != player_p && map::actor_at_pos(p)))
+        {
+            continue;
+        }
 
-                // Metal doors are always blocking
-                if (door->type() == DoorType::metal)
-                {
-                    blocked[x][y] = true;
+        step = p;
 
-                    continue;
-                }
+        step_dist = p_dist;
+    }
 
-                // Not a metal door
+    path.clear();
 
-                //
-                // TODO: What if there is a monster that can open
-                //       doors but not bash, and the door is stuck?
-                //
+    // No free cell closer to the player (e.g. an ally is blocking a corridor),
+    // find a detour around the adjacent actors instead, if there is one
+    if (step.x == -1)
+    {
+        terrain_blocking_mon(mon, blocked);
 
-                // Consider non-metal doors as free if monster can open or bash
-                const ActorDataT& d = mon.data();
+        map_parsers::LivingActorsAdjToPos(mon.pos)
+            .run(blocked,
+                 MapParseMode::append);
 
-                if (d.can_open_doors ||
-                    d.can_bash_doors)
-                {
-                    continue;
-                }
-            }
+        pathfind(mon.pos,
+                 player_p,
+                 blocked,
+                 path);
 
-            // Not a door (e.g. a wall)
-            blocked[x][y] = true;
-        }
+        return;
     }
 
-    // Append living adjacent actors to the blocking array
-    map_parsers::LivingActorsAdjToPos(mon.pos)
-        .run(blocked,
-             MapParseMode::append);
+    // Follow the distance field down to the player (the path is stored from
+    // the player back to the first step)
+    path.push_back(step);
+
+    while (path.back() != player_p)
+    {
+        const P cur(path.back());
+
+        const int cur_dist = dist[cur.x][cur.y];
+
+        for (const P& d : dir_utils::dir_list)
+        {
+            const P p(cur + d);
+
+            // NOTE: Unreachable cells also have a distance of zero, so only
+            //       the player is accepted as the last step
+            if (p == player_p ||
+                (cur_dist > 1 &&
+                 map::is_pos_inside_map(p, false) &&
+                 dist[p.x][p.y] == cur_dist - 1))
+            {
+                path.push_back(p);
+                break;
+            }
+        }
+
+        ASSERT(path.back() != cur);
+    }
 
-    // Find a path
-    pathfind(mon.pos,
-             map::player->pos,
-             blocked,
-             path);
+    std::reverse(begin(path), end(path));
 }
 
 void set_special_blocked_cells(Mon& mon, bool a[map_w][map_h])
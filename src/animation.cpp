@@ -0,0 +1,165 @@
+#include "animation.hpp"
+
+#include "init.hpp"
+#include "io.hpp"
+#include "config.hpp"
+#include "state.hpp"
+#include "sdl_base.hpp"
+
+namespace
+{
+
+// Waits for the given duration, returns true if a key was pressed meanwhile
+bool wait_skippable(const int duration)
+{
+    const Uint32 wait_until = SDL_GetTicks() + duration;
+
+    while (SDL_GetTicks() < wait_until)
+    {
+        SDL_PumpEvents();
+
+        SDL_Event event;
+
+        // NOTE: Only key presses are removed from the queue, other events are
+        //       left for the regular input handling
+        const int nr_keys = SDL_PeepEvents(&event,
+                                           1,
+                                           SDL_GETEVENT,
+                                           SDL_KEYDOWN,
+                                           SDL_KEYDOWN);
+
+        if (nr_keys > 0)
+        {
+            return true;
+        }
+
+        SDL_Delay(1);
+    }
+
+    return false;
+}
+
+} // namespace
+
+AnimScript::AnimScript() :
+    frames_         (),
+    is_recording_   (anim::is_enabled()) {}
+
+void AnimScript::add_frame(const int duration, const bool draw_map_before)
+{
+    if (!is_recording_)
+    {
+        return;
+    }
+
+    frames_.push_back(AnimFrame(duration, draw_map_before));
+}
+
+void AnimScript::add_cell(const P& pos,
+                          const TileId tile,
+                          const char glyph,
+                          const Clr& clr)
+{
+    if (!is_recording_)
+    {
+        return;
+    }
+
+    ASSERT(!frames_.empty());
+
+    frames_.back().cells.push_back(AnimCell(pos, tile, glyph, clr));
+}
+
+void AnimScript::add_blast(const std::vector<P>& positions,
+                           const Clr& clr,
+                           const int duration)
+{
+    if (!is_recording_ || positions.empty())
+    {
+        return;
+    }
+
+    const bool is_tiles = config::is_tiles_mode();
+
+    const int nr_steps = is_tiles ? 2 : 1;
+
+    for (int i = 0; i < nr_steps; ++i)
+    {
+        add_frame(duration / nr_steps);
+
+        const TileId tile = (i == 0) ? TileId::blast1 : TileId::blast2;
+
+        for (const P& p : positions)
+        {
+            add_cell(p, tile, '*', clr);
+        }
+    }
+}
+
+namespace anim
+{
+
+bool is_enabled()
+{
+    return io::is_inited() && !config::is_bot_playing();
+}
+
+void play(const AnimScript& script)
+{
+    if (script.is_empty() || !is_enabled())
+    {
+        return;
+    }
+
+    const bool is_tiles = config::is_tiles_mode();
+
+    for (const AnimFrame& frame : script.frames())
+    {
+        if (frame.draw_map_before)
+        {
+            states::draw();
+        }
+
+        for (const AnimCell& cell : frame.cells)
+        {
+            io::cover_cell_in_map(cell.pos);
+
+            if (is_tiles)
+            {
+                if (cell.tile != TileId::empty)
+                {
+                    io::draw_tile(cell.tile,
+                                  Panel::map,
+                                  cell.pos,
+                                  cell.clr,
+                                  clr_black);
+                }
+            }
+            else // Text mode
+            {
+                if (cell.glyph != -1)
+                {
+                    io::draw_glyph(cell.glyph,
+                                   Panel::map,
+                                   cell.pos,
+                                   cell.clr,
+                                   true,
+                                   clr_black);
+                }
+            }
+        }
+
+        io::update_screen();
+
+        if (frame.duration > 0 &&
+            wait_skippable(frame.duration))
+        {
+            break;
+        }
+    }
+
+    // Do not leave the last frame on the screen
+    states::draw();
+}
+
+} // anim
@@ -16,7 +16,7 @@
 #include "msg_log.hpp"
 #include "line_calc.hpp"
 #include "io.hpp"
-#include "sdl_base.hpp"
+#include "animation.hpp"
 #include "knockback.hpp"
 #include "drop.hpp"
 #include "text_format.hpp"
@@ -1021,6 +1021,28 @@ void fire_projectiles(Actor* const attacker,
 
     const bool leave_trail = wpn.data().ranged.projectile_leaves_trail;
 
+    // The projectiles are resolved all at once, the flight is only recorded
+    // here, and played back when all projectiles are done
+    AnimScript script;
+
+    auto add_projectiles_frame = [&](const int duration)
+    {
+        if (!script.is_recording())
+        {
+            return;
+        }
+
+        script.add_frame(duration, !leave_trail);
+
+        for (const Projectile* const p : projectiles)
+        {
+            if (!p->is_done_rendering && p->is_seen_by_player)
+            {
+                script.add_cell(p->pos, p->tile, p->glyph, p->clr);
+            }
+        }
+    };
+
     const SndVol vol = wpn.data().ranged.snd_vol;
 
     const std::string snd_msg = wpn.data().ranged.snd_msg;
@@ -1157,30 +1179,21 @@ void fire_projectiles(Actor* const attacker,
                         {
                             proj->set_tile(TileId::blast1, clr_red_lgt);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
 
                             proj->set_tile(TileId::blast2, clr_red_lgt);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
                         }
                         else // Text mode
                         {
                             proj->set_glyph('*', clr_red_lgt);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay);
+                            add_projectiles_frame(delay);
                         }
 
                         // MESSAGES FOR ACTOR HIT
                         print_proj_at_actor_msgs(att_data, true, wpn);
-
-                        // Need to draw again here to show log message
-                        io::draw_projectiles(projectiles, !leave_trail);
                     }
 
                     proj->is_done_rendering = true;
@@ -1287,23 +1300,17 @@ void fire_projectiles(Actor* const attacker,
                         {
                             proj->set_tile(TileId::blast1, clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
 
                             proj->set_tile(TileId::blast2, clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
                         }
                         else // Text mode
                         {
                             proj->set_glyph('*', clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay);
+                            add_projectiles_frame(delay);
                         }
                     }
                 } // if feature hit
@@ -1336,23 +1343,17 @@ void fire_projectiles(Actor* const attacker,
                         {
                             proj->set_tile(TileId::blast1, clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
 
                             proj->set_tile(TileId::blast2, clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay / 2);
+                            add_projectiles_frame(delay / 2);
                         }
                         else // Text mode
                         {
                             proj->set_glyph('*', clr_yellow);
 
-                            io::draw_projectiles(projectiles, !leave_trail);
-
-                            sdl_base::sleep(delay);
+                            add_projectiles_frame(delay);
                         }
                     }
                 } // if hit the ground
@@ -1364,14 +1365,10 @@ void fire_projectiles(Actor* const attacker,
                     if (config::is_tiles_mode())
                     {
                         proj->set_tile(projectile_tile, projectile_clr);
-
-                        io::draw_projectiles(projectiles, !leave_trail);
                     }
                     else // Text mode
                     {
                         proj->set_glyph(projectile_glyph, projectile_clr);
-
-                        io::draw_projectiles(projectiles, !leave_trail);
                     }
                 }
             }
@@ -1386,7 +1383,7 @@ void fire_projectiles(Actor* const attacker,
             if (map::cells[pos.x][pos.y].is_seen_by_player &&
                 !projectile->is_dead)
             {
-                sdl_base::sleep(delay);
+                add_projectiles_frame(delay);
                 break;
             }
         }
@@ -1409,6 +1406,8 @@ void fire_projectiles(Actor* const attacker,
 
     } // path loop
 
+    anim::play(script);
+
     // So far, only projectile 0 can have special obstruction events, this
     // must be changed if something like an assault-incinerator is added
     const Projectile* const first_projectile = projectiles[0];
@@ -1478,6 +1477,17 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
     int killed_mon_idx = -1;
 
+    // The shot is resolved all at once, the hits are only recorded here, and
+    // played back afterwards
+    AnimScript script;
+
+    auto add_hit_frame = [&](const P& p, const Clr& clr)
+    {
+        script.add_frame(config::delay_shotgun());
+
+        script.add_cell(p, TileId::blast2, '*', clr);
+    };
+
     // Emit sound
     const bool is_attacker_player = &attacker == map::player;
 
@@ -1575,28 +1585,7 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
                     if (is_seen)
                     {
-                        states::draw();
-
-                        io::cover_cell_in_map(current_pos);
-
-                        if (config::is_tiles_mode())
-                        {
-                            io::draw_tile(TileId::blast2,
-                                              Panel::map,
-                                              current_pos,
-                                              clr_red_lgt);
-                        }
-                        else // Text mode
-                        {
-                            io::draw_glyph('*',
-                                               Panel::map,
-                                               current_pos,
-                                               clr_red_lgt);
-                        }
-
-                        io::update_screen();
-
-                        sdl_base::sleep(config::delay_shotgun());
+                        add_hit_frame(current_pos, clr_red_lgt);
                     }
 
                     // Messages
@@ -1615,8 +1604,6 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
                     ++nr_actors_hit;
 
-                    states::draw();
-
                     // Special shotgun behavior:
                     // If current defender was killed, and player aimed at
                     // humanoid level or at floor level but beyond the current
@@ -1654,31 +1641,11 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
             snd_emit::run(snd);
 
-            Cell& cell = map::cells[current_pos.x][current_pos.y];
+            Cell cell = map::cells[current_pos.x][current_pos.y];
 
             if (cell.is_seen_by_player)
             {
-                states::draw();
-
-                io::cover_cell_in_map(current_pos);
-
-                if (config::is_tiles_mode())
-                {
-                    io::draw_tile(TileId::blast2,
-                                  Panel::map,
-                                  current_pos,
-                                  clr_yellow);
-                }
-                else // Text mode
-                {
-                    io::draw_glyph('*', Panel::map, current_pos, clr_yellow);
-                }
-
-                io::update_screen();
-
-                sdl_base::sleep(config::delay_shotgun());
-
-                states::draw();
+                add_hit_frame(current_pos, clr_yellow);
             }
 
             cell.rigid->hit(
@@ -1706,30 +1673,7 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
             if (map::cells[current_pos.x][current_pos.y].is_seen_by_player)
             {
-                states::draw();
-
-                io::cover_cell_in_map(current_pos);
-
-                if (config::is_tiles_mode())
-                {
-                    io::draw_tile(TileId::blast2,
-                                  Panel::map,
-                                  current_pos,
-                                  clr_yellow);
-                }
-                else
-                {
-                    io::draw_glyph('*',
-                                   Panel::map,
-                                   current_pos,
-                                   clr_yellow);
-                }
-
-                io::update_screen();
-
-                sdl_base::sleep(config::delay_shotgun());
-
-                states::draw();
+                add_hit_frame(current_pos, clr_yellow);
             }
 
             break;
@@ -1738,6 +1682,8 @@ void shotgun(Actor& attacker, const Wpn& wpn, const P& aim_pos)
 
     } // path loop
 
+    anim::play(script);
+
     //
     // See note above
     //
@@ -0,0 +1,288 @@
+#include "bench.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <vector>
+
+#include "init.hpp"
+#include "rl_utils.hpp"
+#include "explosion.hpp"
+#include "line_calc.hpp"
+#include "map_parsing.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+// The explosion reach as originally computed, by tracing the line to each cell
+size_t expl_reach_by_lines(const R& area,
+                           const P& origin,
+                           const bool blocked[map_w][map_h],
+                           std::vector<P>& line)
+{
+    size_t nr_reached = 0;
+
+    for (int y = area.p0.y; y <= area.p1.y; ++y)
+    {
+        for (int x = area.p0.x; x <= area.p1.x; ++x)
+        {
+            const P pos(x, y);
+
+            bool is_reached = true;
+
+            if (king_dist(pos, origin) > 1)
+            {
+                line_calc::calc_new_line(origin, pos, true, 999, false, line);
+
+                for (const P& p : line)
+                {
+                    if (blocked[p.x][p.y])
+                    {
+                        is_reached = false;
+                        break;
+                    }
+                }
+            }
+
+            if (is_reached)
+            {
+                ++nr_reached;
+            }
+        }
+    }
+
+    return nr_reached;
+}
+
+void run_explosion_reach(std::ostream& out)
+{
+    bool blocked[map_w][map_h];
+
+    rnd::seed(1);
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            blocked[x][y] = rnd::percent(20);
+        }
+    }
+
+    const P origin(map_w / 2, map_h / 2);
+
+    const int nr_reps = 100000;
+
+    std::vector<P> line;
+
+    ExplReach reach;
+
+    out << "Explosion reach (us per explosion)" << std::endl
+        << std::left
+        << std::setw(8)  << "Radius"
+        << std::setw(12) << "Lines"
+        << std::setw(12) << "Masks" << std::endl;
+
+    for (int radi = 1; radi <= 5; ++radi)
+    {
+        const R area = explosion::explosion_area(origin, radi);
+
+        size_t nr_reached_lines = 0;
+        size_t nr_reached_masks = 0;
+
+        const auto t0 = Clock::now();
+
+        for (int i = 0; i < nr_reps; ++i)
+        {
+            nr_reached_lines +=
+                expl_reach_by_lines(area, origin, blocked, line);
+        }
+
+        const auto t1 = Clock::now();
+
+        for (int i = 0; i < nr_reps; ++i)
+        {
+            explosion::cells_reached(area,
+                                     origin,
+                                     ExplExclCenter::no,
+                                     blocked,
+                                     reach);
+
+            nr_reached_masks += reach.cells.size();
+        }
+
+        const auto t2 = Clock::now();
+
+        const double us_lines =
+            std::chrono::duration<double, std::micro>(t1 - t0).count() /
+            nr_reps;
+
+        const double us_masks =
+            std::chrono::duration<double, std::micro>(t2 - t1).count() /
+            nr_reps;
+
+        out << std::setw(8)  << radi
+            << std::setw(12) << us_lines
+            << std::setw(12) << us_masks;
+
+        // The results must be the same, or the timings are meaningless
+        if (nr_reached_lines != nr_reached_masks)
+        {
+            out << "RESULTS DIFFER";
+        }
+
+        out << std::endl;
+    }
+}
+
+// Expanding a map layer as originally done, by scanning the neighbours of each
+// cell in the area for any set cell
+void expand_by_cells(const bool in[map_w][map_h],
+                     bool out[map_w][map_h],
+                     const R& area,
+                     const int dist)
+{
+    for (int x = area.p0.x; x <= area.p1.x; ++x)
+    {
+        for (int y = area.p0.y; y <= area.p1.y; ++y)
+        {
+            out[x][y] = false;
+
+            const int cmp_x0 = std::max(x - dist, 0);
+            const int cmp_y0 = std::max(y - dist, 0);
+            const int cmp_x1 = std::min(x + dist, map_w - 1);
+            const int cmp_y1 = std::min(y + dist, map_h - 1);
+
+            for (int cmp_x = cmp_x0; cmp_x <= cmp_x1 && !out[x][y]; ++cmp_x)
+            {
+                for (int cmp_y = cmp_y0; cmp_y <= cmp_y1; ++cmp_y)
+                {
+                    if (in[cmp_x][cmp_y])
+                    {
+                        out[x][y] = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void run_map_expand(std::ostream& out)
+{
+    bool in[map_w][map_h];
+
+    bool out_cells[map_w][map_h] = {};
+    bool out_bits[map_w][map_h] = {};
+
+    const int nr_reps = 100000;
+
+    const R map_area(0, 0, map_w - 1, map_h - 1);
+
+    // A room sized area, as when expanding around a single room
+    const R room_area(map_w / 2 - 5, map_h / 2 - 3,
+                      map_w / 2 + 5, map_h / 2 + 3);
+
+    out << "Map layer expansion (us per expansion)" << std::endl
+        << std::left
+        << std::setw(8)  << "Set %"
+        << std::setw(12) << "Area"
+        << std::setw(8)  << "Dist"
+        << std::setw(12) << "Cells"
+        << std::setw(12) << "Bitset" << std::endl;
+
+    for (const int set_pct : {5, 30, 70})
+    {
+        rnd::seed(1);
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                in[x][y] = rnd::percent(set_pct);
+            }
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const bool is_room = (i == 1);
+
+            const R& area = is_room ? room_area : map_area;
+
+            const int dist = (i == 2) ? 3 : 1;
+
+            const auto t0 = Clock::now();
+
+            for (int rep = 0; rep < nr_reps; ++rep)
+            {
+                expand_by_cells(in, out_cells, area, dist);
+            }
+
+            const auto t1 = Clock::now();
+
+            for (int rep = 0; rep < nr_reps; ++rep)
+            {
+                if (dist == 1)
+                {
+                    map_parsers::expand(in, out_bits, area);
+                }
+                else
+                {
+                    map_parsers::expand(in, out_bits, dist);
+                }
+            }
+
+            const auto t2 = Clock::now();
+
+            const double us_cells =
+                std::chrono::duration<double, std::micro>(t1 - t0).count() /
+                nr_reps;
+
+            const double us_bits =
+                std::chrono::duration<double, std::micro>(t2 - t1).count() /
+                nr_reps;
+
+            out << std::setw(8)  << set_pct
+                << std::setw(12) << (is_room ? "Room" : "Map")
+                << std::setw(8)  << dist
+                << std::setw(12) << us_cells
+                << std::setw(12) << us_bits;
+
+            bool is_same = true;
+
+            for (int x = area.p0.x; x <= area.p1.x; ++x)
+            {
+                for (int y = area.p0.y; y <= area.p1.y; ++y)
+                {
+                    if (out_cells[x][y] != out_bits[x][y])
+                    {
+                        is_same = false;
+                    }
+                }
+            }
+
+            if (!is_same)
+            {
+                out << "RESULTS DIFFER";
+            }
+
+            out << std::endl;
+        }
+    }
+}
+
+} // namespace
+
+void run(std::ostream& out)
+{
+    run_explosion_reach(out);
+
+    out << std::endl;
+
+    run_map_expand(out);
+}
+
+} // bench
@@ -3,6 +3,8 @@
 #include "bot.hpp"
 
 #include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <vector>
 
 #include "properties.hpp"
@@ -22,6 +24,7 @@
 #include "explosion.hpp"
 #include "io.hpp"
 #include "sdl_base.hpp"
+#include "flood_workspace.hpp"
 
 namespace bot
 {
@@ -31,6 +34,8 @@ namespace
 
 std::vector<P> path_;
 
+FloodWorkspace flood_;
+
 void show_map_and_freeze(const std::string& msg)
 {
     TRACE_FUNC_BEGIN;
@@ -39,7 +44,7 @@ void show_map_and_freeze(const std::string& msg)
     {
         for (int y = 0; y < map_h; ++y)
         {
-            Cell& cell = map::cells[x][y];
+            Cell cell = map::cells[x][y];
 
             cell.is_explored = true;
             cell.is_seen_by_player = true;
@@ -56,6 +61,15 @@ void show_map_and_freeze(const std::string& msg)
         }
     }
 
+    // Running headless (e.g. batch simulation) - there is nobody to look at
+    // the map, so report the problem and give up instead of freezing forever
+    if (!io::is_inited())
+    {
+        std::cerr << "Bot error: " << msg << std::endl;
+
+        exit(EXIT_FAILURE);
+    }
+
     while (true)
     {
         io::draw_text("[" + msg + "]",
@@ -112,10 +126,10 @@ void find_stair_path()
         show_map_and_freeze("Player on blocked position");
     }
 
-    pathfind(player_p,
-                   stair_p,
-                   blocked,
-                   path_);
+    flood_.pathfind(player_p,
+                    stair_p,
+                    blocked,
+                    path_);
 
     if (path_.empty())
     {
@@ -155,37 +169,33 @@ void act()
     // TESTS
     // =======================================================================
 #ifndef NDEBUG
-    for (size_t outer_idx = 0;
-         outer_idx < game_time::actors.size();
-         ++outer_idx)
+    for (const Actor* const actor : game_time::actors)
     {
-        const Actor* const actor = game_time::actors[outer_idx];
-
         ASSERT(map::is_pos_inside_map(actor->pos));
 
-        for (size_t inner_idx = 0;
-             inner_idx < game_time::actors.size();
-             ++inner_idx)
+        if (!actor->is_alive())
         {
-            const Actor* const other_actor = game_time::actors[inner_idx];
+            continue;
+        }
+
+        // NOTE: Only the actors in the same cell need to be checked
+        int nr_living_here = 0;
 
-            if (outer_idx != inner_idx  &&
-                actor->is_alive()       &&
-                other_actor->is_alive())
+        for (const Actor* const other_actor :
+             game_time::actors_at_pos(actor->pos))
+        {
+            if (other_actor->is_alive())
             {
-                if (actor == other_actor)
-                {
-                    show_map_and_freeze("Same actor encountered twice in list");
-                }
-
-                if (actor->pos == other_actor->pos)
-                {
-                    show_map_and_freeze("Two living actors at same pos (" +
-                                        std::to_string(actor->pos.x) + ", " +
-                                        std::to_string(actor->pos.y) + ")");
-                }
+                ++nr_living_here;
             }
         }
+
+        if (nr_living_here > 1)
+        {
+            show_map_and_freeze("Two living actors at same pos (" +
+                                std::to_string(actor->pos.x) + ", " +
+                                std::to_string(actor->pos.y) + ")");
+        }
     }
 #endif
     // =======================================================================
@@ -41,6 +41,7 @@ const int opt_values_x_pos_ = 40;
 std::string font_name_ = "";
 bool use_light_fade_effect_ = false;
 bool is_fullscr_ = false;
+bool is_gpu_rendering_ = false;
 bool is_tiles_wall_full_square_ = false;
 bool is_text_mode_wall_full_square_ = false;
 bool is_light_explosive_prompt_ = false;
@@ -144,6 +145,7 @@ void set_default_variables()
 
     use_light_fade_effect_ = false;
     is_fullscr_ = false;
+    is_gpu_rendering_ = true;
     is_tiles_wall_full_square_ = false;
     is_text_mode_wall_full_square_ = true;
     is_intro_lvl_skipped_ = false;
@@ -247,49 +249,59 @@ void player_sets_option(const MenuBrowser& browser)
     }
     break;
 
-    case 5: // Tiles mode wall symbol
+    case 5: // GPU rendering
+    {
+        is_gpu_rendering_ = !is_gpu_rendering_;
+
+        sdl_base::init();
+
+        io::init();
+    }
+    break;
+
+    case 6: // Tiles mode wall symbol
     {
         is_tiles_wall_full_square_ = !is_tiles_wall_full_square_;
     }
     break;
 
-    case 6: // Text mode wall symbol
+    case 7: // Text mode wall symbol
     {
         is_text_mode_wall_full_square_ = !is_text_mode_wall_full_square_;
     }
     break;
 
-    case 7: // Skip intro level
+    case 8: // Skip intro level
     {
         is_intro_lvl_skipped_ = !is_intro_lvl_skipped_;
     }
     break;
 
-    case 8: // Confirm "more" with any key
+    case 9: // Confirm "more" with any key
     {
         is_any_key_confirm_more_ = !is_any_key_confirm_more_;
     }
     break;
 
-    case 9: // Print warning when lighting explovies
+    case 10: // Print warning when lighting explovies
     {
         is_light_explosive_prompt_ = !is_light_explosive_prompt_;
     }
     break;
 
-    case 10: // Print warning when melee attacking with ranged weapons
+    case 11: // Print warning when melee attacking with ranged weapons
     {
         is_ranged_wpn_meleee_prompt_ = !is_ranged_wpn_meleee_prompt_;
     }
     break;
 
-    case 11: // Ranged weapon auto reload
+    case 12: // Ranged weapon auto reload
     {
         is_ranged_wpn_auto_reload_ = !is_ranged_wpn_auto_reload_;
     }
     break;
 
-    case 12: // Projectile delay
+    case 13: // Projectile delay
     {
         const P p(opt_values_x_pos_, opt_y0_ + browser.y());
 
@@ -308,7 +320,7 @@ void player_sets_option(const MenuBrowser& browser)
     }
     break;
 
-    case 13: // Shotgun delay
+    case 14: // Shotgun delay
     {
         const P p(opt_values_x_pos_, opt_y0_ + browser.y());
 
@@ -327,7 +339,7 @@ void player_sets_option(const MenuBrowser& browser)
     }
     break;
 
-    case 14: // Explosion delay
+    case 15: // Explosion delay
     {
         const P p(opt_values_x_pos_, opt_y0_ + browser.y());
 
@@ -346,7 +358,7 @@ void player_sets_option(const MenuBrowser& browser)
     }
     break;
 
-    case 15: // Reset to defaults
+    case 16: // Reset to defaults
     {
         set_default_variables();
 
@@ -445,6 +457,13 @@ void set_variables_from_lines(std::vector<std::string>& lines)
     }
     lines.erase(begin(lines));
 
+    // NOTE: This option was added later, older config files do not have it
+    if (!lines.empty())
+    {
+        is_gpu_rendering_ = lines.front() == "1";
+        lines.erase(begin(lines));
+    }
+
     ASSERT(lines.empty());
 
     TRACE_FUNC_END;
@@ -502,6 +521,8 @@ std::vector<std::string> lines_from_variables()
         lines.push_back(default_player_name_);
     }
 
+    lines.push_back(is_gpu_rendering_ ? "1" : "0");
+
     TRACE_FUNC_END;
 
     return lines;
@@ -550,6 +571,11 @@ bool is_fullscreen()
     return is_fullscr_;
 }
 
+bool is_gpu_rendering()
+{
+    return is_gpu_rendering_;
+}
+
 int scr_px_w()
 {
     return scr_px_w_;
@@ -702,7 +728,7 @@ void toggle_fullscreen()
 // -----------------------------------------------------------------------------
 ConfigState::ConfigState() :
     State       (),
-    browser_    (16)
+    browser_    (17)
 {
 
 }
@@ -790,6 +816,11 @@ void ConfigState::draw()
             config::is_fullscr_ ? "Yes" : "No"
         },
 
+        {
+            "GPU rendering",
+            config::is_gpu_rendering_ ? "Yes" : "No"
+        },
+
         {
             "Tiles mode wall symbol",
             config::is_tiles_wall_full_square_ ? "Full square" : "Pseudo-3D"
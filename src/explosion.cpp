@@ -1,13 +1,14 @@
 #include "explosion.hpp"
 
+#include <cstdint>
+
 #include "io.hpp"
 #include "map.hpp"
 #include "msg_log.hpp"
 #include "map_parsing.hpp"
-#include "sdl_base.hpp"
 #include "line_calc.hpp"
 #include "actor_player.hpp"
-#include "sdl_base.hpp"
+#include "animation.hpp"
 #include "player_bon.hpp"
 #include "feature_rigid.hpp"
 #include "feature_mob.hpp"
@@ -16,70 +17,93 @@
 namespace
 {
 
-std::vector< std::vector<P> > cells_reached(const R& area,
-                                            const P& origin,
-                                            const ExplExclCenter exclude_center,
-                                            bool blocked[map_w][map_h])
+//
+// The line from the origin to each cell within this radius is stored as a bit
+// mask over the square around the origin. The blocked cells around an origin
+// are collected into the same kind of mask, so checking if a cell is reached
+// is just an "and" of a couple of words, instead of tracing a line.
+//
+const int mask_radi_        = 5;
+const int mask_w_           = (mask_radi_ * 2) + 1;
+const int nr_mask_words_    = ((mask_w_ * mask_w_) + 63) / 64;
+
+struct CellMask
 {
-    std::vector< std::vector<P> > out;
+    CellMask()
+    {
+        for (int i = 0; i < nr_mask_words_; ++i)
+        {
+            words[i] = 0;
+        }
+    }
 
-    std::vector<P> line;
+    void set(const P& offset)
+    {
+        const int bit =
+            ((offset.y + mask_radi_) * mask_w_) + offset.x + mask_radi_;
+
+        words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
 
-    for (int y = area.p0.y; y <= area.p1.y; ++y)
+    bool is_any_common(const CellMask& other) const
     {
-        for (int x = area.p0.x; x <= area.p1.x; ++x)
+        uint64_t common = 0;
+
+        for (int i = 0; i < nr_mask_words_; ++i)
         {
-            const P pos(x, y);
+            common |= words[i] & other.words[i];
+        }
 
-            if (exclude_center == ExplExclCenter::yes &&
-                pos == origin)
-            {
-                continue;
-            }
+        return common != 0;
+    }
 
-            const int dist = king_dist(pos, origin);
+    uint64_t words[nr_mask_words_];
+};
 
-            bool is_reached = true;
+const CellMask& line_mask(const P& offset)
+{
+    // NOTE: Lines only depend on the delta between origin and target, so the
+    //       masks can be traced from any origin
+    static const std::vector<CellMask> masks = []()
+    {
+        std::vector<CellMask> result(mask_w_ * mask_w_);
 
-            if (dist > 1)
-            {
-                line_calc::calc_new_line(origin,
-                                         pos,
-                                         true,
-                                         999,
-                                         false,
-                                         line);
-
-                for (P& pos_check_block : line)
-                {
-                    if (blocked[pos_check_block.x][pos_check_block.y])
-                    {
-                        is_reached = false;
-                        break;
-                    }
-                }
-            }
+        std::vector<P> line;
 
-            if (is_reached)
+        for (int y = -mask_radi_; y <= mask_radi_; ++y)
+        {
+            for (int x = -mask_radi_; x <= mask_radi_; ++x)
             {
-                if ((int)out.size() <= dist)
+                const P d(x, y);
+
+                line_calc::calc_new_line(P(0, 0), d, true, 999, true, line);
+
+                CellMask& mask =
+                    result[((y + mask_radi_) * mask_w_) + x + mask_radi_];
+
+                for (const P& p : line)
                 {
-                    out.resize(dist + 1);
+                    mask.set(p);
                 }
-
-                out[dist].push_back(pos);
             }
         }
-    }
 
-    return out;
+        return result;
+    }();
+
+    return masks[((offset.y + mask_radi_) * mask_w_) + offset.x + mask_radi_];
 }
 
-void draw(const std::vector< std::vector<P> >& pos_lists,
+void draw(const ExplReach& reach,
           bool blocked[map_w][map_h],
           const Clr* const clr_override)
 {
-    states::draw();
+    AnimScript script;
+
+    if (!script.is_recording())
+    {
+        return;
+    }
 
     const Clr& clr_inner = clr_override ? *clr_override : clr_yellow;
     const Clr& clr_outer = clr_override ? *clr_override : clr_red_lgt;
@@ -87,59 +111,37 @@ void draw(const std::vector< std::vector<P> >& pos_lists,
     const bool is_tiles     = config::is_tiles_mode();
     const int nr_anim_steps = is_tiles ? 2 : 1;
 
-    bool is_any_cell_seen_by_player = false;
-
     for (int i_anim = 0; i_anim < nr_anim_steps; i_anim++)
     {
+        script.add_frame(config::delay_explosion() / nr_anim_steps);
+
         const TileId tile =
             (i_anim == 0) ?
             TileId::blast1 : TileId::blast2;
 
-        const int nr_outer = pos_lists.size();
-
-        for (int i_outer = 0; i_outer < nr_outer; i_outer++)
+        for (const ExplCell& expl_cell : reach.cells)
         {
+            const P& pos = expl_cell.pos;
+
             const Clr& clr =
-                (i_outer == nr_outer - 1) ?
+                (expl_cell.dist == reach.nr_dists - 1) ?
                 clr_outer : clr_inner;
 
-            const std::vector<P>& inner = pos_lists[i_outer];
-
-            for (const P& pos : inner)
+            if (map::cells[pos.x][pos.y].is_seen_by_player &&
+                !blocked[pos.x][pos.y])
             {
-                if (map::cells[pos.x][pos.y].is_seen_by_player &&
-                    !blocked[pos.x][pos.y])
-                {
-                    is_any_cell_seen_by_player = true;
-
-                    if (is_tiles)
-                    {
-                        io::draw_tile(tile,
-                                      Panel::map,
-                                      pos,
-                                      clr,
-                                      clr_black);
-                    }
-                    else
-                    {
-                        io::draw_glyph('*',
-                                       Panel::map,
-                                       pos,
-                                       clr,
-                                       true,
-                                       clr_black);
-                    }
-                }
+                script.add_cell(pos, tile, '*', clr);
             }
         }
 
-        if (is_any_cell_seen_by_player)
+        // Nothing seen, no need to wait
+        if (script.frames().back().cells.empty())
         {
-            io::update_screen();
-
-            sdl_base::sleep(config::delay_explosion() / nr_anim_steps);
+            return;
         }
     }
+
+    anim::play(script);
 }
 
 } // namespace
@@ -168,10 +170,13 @@ void run(const P& origin,
             MapParseMode::overwrite,
             area);
 
-    auto pos_lists = cells_reached(area,
-                                   origin,
-                                   exclude_center,
-                                   blocked);
+    ExplReach reach;
+
+    cells_reached(area,
+                  origin,
+                  exclude_center,
+                  blocked,
+                  reach);
 
     if (emit_expl_snd == EmitExplSnd::yes)
     {
@@ -186,7 +191,7 @@ void run(const P& origin,
         snd_emit::run(snd);
     }
 
-    draw(pos_lists, blocked, clr_override);
+    draw(reach, blocked, clr_override);
 
     //
     // Do damage, apply effect
@@ -220,83 +225,102 @@ void run(const P& origin,
 
     const bool is_dem_exp = player_bon::traits[(size_t)Trait::dem_expert];
 
-    const int nr_outer = pos_lists.size();
-
-    for (int radi = 0; radi < nr_outer; ++radi)
+    for (const ExplCell& expl_cell : reach.cells)
     {
-        const std::vector<P>& positions_at_radi = pos_lists[radi];
+        const P& pos = expl_cell.pos;
 
-        for (const P& pos : positions_at_radi)
-        {
-            Actor* living_actor = living_actors[pos.x][pos.y];
+        Actor* living_actor = living_actors[pos.x][pos.y];
 
-            std::vector<Actor*> corpses_here = corpses[pos.x][pos.y];
+        std::vector<Actor*> corpses_here = corpses[pos.x][pos.y];
 
-            if (expl_type == ExplType::expl)
-            {
-                const int rolls = expl_dmg_rolls - radi;
+        if (expl_type == ExplType::expl)
+        {
+            const int rolls = expl_dmg_rolls - expl_cell.dist;
 
-                const int dmg =
-                    rnd::dice(rolls, expl_dmg_sides) +
-                    expl_dmg_plus;
+            const int dmg =
+                rnd::dice(rolls, expl_dmg_sides) +
+                expl_dmg_plus;
 
-                // Damage environment
-                Cell& cell = map::cells[pos.x][pos.y];
+            // Damage environment
+            Cell cell = map::cells[pos.x][pos.y];
 
-                cell.rigid->hit(dmg,
-                                DmgType::physical,
-                                DmgMethod::explosion,
-                                nullptr);
+            cell.rigid->hit(dmg,
+                            DmgType::physical,
+                            DmgMethod::explosion,
+                            nullptr);
 
-                // Damage living actor
-                if (living_actor)
+            // Damage living actor
+            if (living_actor)
+            {
+                if (living_actor->is_player())
                 {
-                    if (living_actor->is_player())
-                    {
-                        msg_log::add("I am hit by an explosion!", clr_msg_bad);
-                    }
-
-                    living_actor->hit(dmg, DmgType::physical);
-
-                    if (living_actor->is_alive() && living_actor->is_player())
-                    {
-                        // Player survived being hit by an explosion, that's
-                        // pretty cool!
-                        game::add_history_event("Survived an explosion.");
-                    }
+                    msg_log::add("I am hit by an explosion!", clr_msg_bad);
                 }
 
-                // Damage dead actors
-                for (Actor* corpse : corpses_here)
-                {
-                    corpse->hit(dmg, DmgType::physical);
-                }
+                living_actor->hit(dmg, DmgType::physical);
 
-                // Add smoke
-                if (rnd::fraction(6, 10))
+                if (living_actor->is_alive() && living_actor->is_player())
                 {
-                    game_time::add_mob(new Smoke(pos, rnd::range(2, 4)));
+                    // Player survived being hit by an explosion, that's
+                    // pretty cool!
+                    game::add_history_event("Survived an explosion.");
                 }
             }
 
-            // Apply properties
-            for (auto* prop : properties_applied)
+            // Damage dead actors
+            for (Actor* corpse : corpses_here)
             {
-                bool should_apply_on_living_actor = (living_actor != nullptr);
-
-                // Do not apply burning if actor is player with the demolition
-                // expert trait, and  intentionally throwing a Molotov
-                if (living_actor == map::player &&
-                    prop->id() == PropId::burning &&
-                    is_dem_exp &&
-                    expl_src == ExplSrc::player_use_moltv_intended)
-                {
-                    should_apply_on_living_actor = false;
-                }
+                corpse->hit(dmg, DmgType::physical);
+            }
+
+            // Add smoke
+            if (rnd::fraction(6, 10))
+            {
+                game_time::add_mob(new Smoke(pos, rnd::range(2, 4)));
+            }
+        }
+
+        // Apply properties
+        for (auto* prop : properties_applied)
+        {
+            bool should_apply_on_living_actor = (living_actor != nullptr);
+
+            // Do not apply burning if actor is player with the demolition
+            // expert trait, and  intentionally throwing a Molotov
+            if (living_actor == map::player &&
+                prop->id() == PropId::burning &&
+                is_dem_exp &&
+                expl_src == ExplSrc::player_use_moltv_intended)
+            {
+                should_apply_on_living_actor = false;
+            }
+
+            if (should_apply_on_living_actor)
+            {
+                PropHandler& prop_hlr = living_actor->prop_handler();
+
+                Prop* prop_cpy =
+                    prop_hlr.mk_prop(prop->id(),
+                                     PropTurns::specific,
+                                     prop->nr_turns_left());
+
+                prop_hlr.apply(prop_cpy);
+            }
+
+            // If property is burning, also apply it to corpses and the
+            // environment
+            if (prop->id() == PropId::burning)
+            {
+                Cell cell = map::cells[pos.x][pos.y];
+
+                cell.rigid->hit(1, // Doesn't matter
+                                DmgType::fire,
+                                DmgMethod::elemental,
+                                nullptr);
 
-                if (should_apply_on_living_actor)
+                for (Actor* corpse : corpses_here)
                 {
-                    PropHandler& prop_hlr = living_actor->prop_handler();
+                    PropHandler& prop_hlr = corpse->prop_handler();
 
                     Prop* prop_cpy =
                         prop_hlr.mk_prop(prop->id(),
@@ -305,30 +329,6 @@ void run(const P& origin,
 
                     prop_hlr.apply(prop_cpy);
                 }
-
-                // If property is burning, also apply it to corpses and the
-                // environment
-                if (prop->id() == PropId::burning)
-                {
-                    Cell& cell = map::cells[pos.x][pos.y];
-
-                    cell.rigid->hit(1, // Doesn't matter
-                                    DmgType::fire,
-                                    DmgMethod::elemental,
-                                    nullptr);
-
-                    for (Actor* corpse : corpses_here)
-                    {
-                        PropHandler& prop_hlr = corpse->prop_handler();
-
-                        Prop* prop_cpy =
-                            prop_hlr.mk_prop(prop->id(),
-                                             PropTurns::specific,
-                                             prop->nr_turns_left());
-
-                        prop_hlr.apply(prop_cpy);
-                    }
-                }
             }
         }
     }
@@ -355,10 +355,13 @@ void run_smoke_explosion_at(const P& origin, const int radi_change)
              MapParseMode::overwrite,
              area);
 
-    auto pos_lists = cells_reached(area,
-                                   origin,
-                                   ExplExclCenter::no,
-                                   blocked);
+    ExplReach reach;
+
+    cells_reached(area,
+                  origin,
+                  ExplExclCenter::no,
+                  blocked,
+                  reach);
 
     // TODO: Sound message?
     Snd snd("",
@@ -371,14 +374,13 @@ void run_smoke_explosion_at(const P& origin, const int radi_change)
 
     snd_emit::run(snd);
 
-    for (const std::vector<P>& inner : pos_lists)
+    for (const ExplCell& expl_cell : reach.cells)
     {
-        for (const P& pos : inner)
+        const P& pos = expl_cell.pos;
+
+        if (!blocked[pos.x][pos.y])
         {
-            if (!blocked[pos.x][pos.y])
-            {
-                game_time::add_mob(new Smoke(pos, rnd::range(25, 30)));
-            }
+            game_time::add_mob(new Smoke(pos, rnd::range(25, 30)));
         }
     }
 
@@ -393,4 +395,110 @@ R explosion_area(const P& c, const int radi)
                std::min(c.y + radi, map_h - 2)));
 }
 
+void cells_reached(const R& area,
+                   const P& origin,
+                   const ExplExclCenter exclude_center,
+                   const bool blocked[map_w][map_h],
+                   ExplReach& out)
+{
+    out.cells.clear();
+
+    out.nr_dists = 0;
+
+    const int max_dist =
+        std::max(std::max(origin.x - area.p0.x, area.p1.x - origin.x),
+                 std::max(origin.y - area.p0.y, area.p1.y - origin.y));
+
+    // Larger explosions (if any) fall back on tracing each line
+    const bool is_masked = max_dist <= mask_radi_;
+
+    CellMask blocked_mask;
+
+    if (is_masked)
+    {
+        for (int y = area.p0.y; y <= area.p1.y; ++y)
+        {
+            for (int x = area.p0.x; x <= area.p1.x; ++x)
+            {
+                if (blocked[x][y])
+                {
+                    blocked_mask.set(P(x, y) - origin);
+                }
+            }
+        }
+    }
+
+    std::vector<P> line;
+
+    auto is_reached = [&](const P& p, const int dist)
+    {
+        if (dist <= 1)
+        {
+            return true;
+        }
+
+        if (is_masked)
+        {
+            return !line_mask(p - origin).is_any_common(blocked_mask);
+        }
+
+        line_calc::calc_new_line(origin, p, true, 999, false, line);
+
+        for (const P& line_p : line)
+        {
+            if (blocked[line_p.x][line_p.y])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto try_add = [&](const P& p, const int dist)
+    {
+        if (is_reached(p, dist))
+        {
+            out.cells.push_back({p, dist});
+
+            out.nr_dists = dist + 1;
+        }
+    };
+
+    const int dist_start = (exclude_center == ExplExclCenter::yes) ? 1 : 0;
+
+    // Walk the rings around the origin, each ring from top left to bottom
+    // right
+    for (int dist = dist_start; dist <= max_dist; ++dist)
+    {
+        const int x0 = std::max(area.p0.x, origin.x - dist);
+        const int x1 = std::min(area.p1.x, origin.x + dist);
+        const int y0 = std::max(area.p0.y, origin.y - dist);
+        const int y1 = std::min(area.p1.y, origin.y + dist);
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            if (std::abs(y - origin.y) == dist)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    try_add(P(x, y), dist);
+                }
+            }
+            else // Only the left and right side of the ring
+            {
+                if (origin.x - dist >= area.p0.x)
+                {
+                    try_add(P(origin.x - dist, y), dist);
+                }
+
+                if (origin.x + dist <= area.p1.x)
+                {
+                    try_add(P(origin.x + dist, y), dist);
+                }
+            }
+        }
+    }
+}
+
 } // explosion
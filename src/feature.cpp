@@ -37,10 +37,6 @@ void Feature::bump(Actor& actor_bumping)
     }
 }
 
-void Feature::add_light(bool light[map_w][map_h]) const
-{
-    (void)light;
-}
 
 void Feature::reveal(const Verbosity verbosity)
 {
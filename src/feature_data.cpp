@@ -47,6 +47,8 @@ namespace feature_data
 
 FeatureDataT data_list[(size_t)FeatureId::END];
 
+uint8_t flags_list[(size_t)FeatureId::END];
+
 namespace
 {
 
@@ -67,6 +69,7 @@ void reset_data(FeatureDataT& d)
     d.can_have_rigid = true;
     d.can_have_item = true;
     d.is_bottomless = false;
+    d.is_passability_dynamic = false;
     d.matl_type = Matl::stone;
     d.msg_on_player_blocked = "The way is blocked.";
     d.msg_on_player_blocked_blind = "I bump into something.";
@@ -615,6 +618,7 @@ void init_data_list()
     {
         return new Door(p);
     };
+    d.is_passability_dynamic = true;
     d.can_have_blood = false;
     d.can_have_gore = false;
     d.can_have_corpse = false;
@@ -691,12 +695,60 @@ void init_data_list()
     add_to_list_and_reset(d);
 }
 
+void init_flags_list()
+{
+    for (size_t i = 0; i < (size_t)FeatureId::END; ++i)
+    {
+        const FeatureDataT& d = data_list[i];
+
+        uint8_t f = 0;
+
+        if (!d.is_los_passable)
+        {
+            f |= feature_flag::blocks_los;
+        }
+
+        if (!d.move_rules.can_move_common())
+        {
+            f |= feature_flag::blocks_move_common;
+        }
+
+        if (!d.is_projectile_passable)
+        {
+            f |= feature_flag::blocks_projectiles;
+        }
+
+        if (!d.can_have_item)
+        {
+            f |= feature_flag::blocks_items;
+        }
+
+        if (!d.can_have_rigid)
+        {
+            f |= feature_flag::blocks_rigid;
+        }
+
+        if (!d.is_sound_passable)
+        {
+            f |= feature_flag::blocks_sound;
+        }
+
+        if (d.is_passability_dynamic)
+        {
+            f |= feature_flag::dynamic;
+        }
+
+        flags_list[i] = f;
+    }
+}
+
 } // namespace
 
 void init()
 {
     TRACE_FUNC_BEGIN;
     init_data_list();
+    init_flags_list();
     TRACE_FUNC_END;
 }
 
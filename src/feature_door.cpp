@@ -682,6 +682,24 @@ Matl Door::matl() const
     return Matl::wood;
 }
 
+void Door::set_secret()
+{
+    ASSERT(type_ != DoorType::gate);
+
+    is_open_ = false;
+    is_secret_ = true;
+
+    map::on_terrain_changed(pos_);
+}
+
+void Door::set_stuck()
+{
+    is_open_ = false;
+    is_stuck_ = true;
+
+    map::on_terrain_changed(pos_);
+}
+
 void Door::bump(Actor& actor_bumping)
 {
     if (!actor_bumping.is_player())
@@ -864,6 +882,8 @@ void Door::try_close(Actor* actor_trying)
             {
                 is_open_ = false;
 
+                map::on_terrain_changed(pos_);
+
                 if (is_player)
                 {
                     Snd snd("",
@@ -925,6 +945,8 @@ void Door::try_close(Actor* actor_trying)
         {
             is_open_ = false;
 
+            map::on_terrain_changed(pos_);
+
             if (is_player)
             {
                 const auto alerts_mon =
@@ -1033,6 +1055,8 @@ void Door::try_open(Actor* actor_trying)
             TRACE << "Tryer can see, opening" << std::endl;
             is_open_ = true;
 
+            map::on_terrain_changed(pos_);
+
             if (is_player)
             {
                 const auto alerts_mon =
@@ -1090,6 +1114,8 @@ void Door::try_open(Actor* actor_trying)
 
                 is_open_ = true;
 
+                map::on_terrain_changed(pos_);
+
                 if (is_player)
                 {
                     Snd snd("",
@@ -1219,6 +1245,8 @@ DidOpen Door::open(Actor* const actor_opening)
 
     is_open_ = true;
 
+    map::on_terrain_changed(pos_);
+
     is_secret_= false;
 
     is_stuck_ = false;
@@ -1248,6 +1276,8 @@ DidClose Door::close(Actor* const actor_closing)
 
     is_open_ = false;
 
+    map::on_terrain_changed(pos_);
+
     //
     // TODO: This is kind of a hack...
     //
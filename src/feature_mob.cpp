@@ -193,37 +193,9 @@ void LitFlare::on_new_turn()
     }
 }
 
-void LitFlare::add_light(bool light[map_w][map_h]) const
+LgtSize LitFlare::lgt_size() const
 {
-    const int radi = fov_std_radi_int; //light_radius();
-
-    P p0(std::max(0, pos_.x - radi),
-         std::max(0, pos_.y - radi));
-
-    P p1(std::min(map_w - 1, pos_.x + radi),
-         std::min(map_h - 1, pos_.y + radi));
-
-    bool hard_blocked[map_w][map_h];
-
-    map_parsers::BlocksLos()
-        .run(hard_blocked,
-             MapParseMode::overwrite,
-             R(p0, p1));
-
-    LosResult fov[map_w][map_h];
-
-    fov::run(pos_, hard_blocked, fov);
-
-    for (int y = p0.y; y <= p1.y; ++y)
-    {
-        for (int x = p0.x; x <= p1.x; ++x)
-        {
-            if (!fov[x][y].is_blocked_hard)
-            {
-                light[x][y] = true;
-            }
-        }
-    }
+    return LgtSize::fov;
 }
 
 std::string LitFlare::name(const Article article)  const
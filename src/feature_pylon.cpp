@@ -8,6 +8,14 @@
 #include "msg_log.hpp"
 #include "sound.hpp"
 #include "knockback.hpp"
+#include "flood_workspace.hpp"
+
+namespace
+{
+
+FloodWorkspace flood_;
+
+} // namespace
 
 // -----------------------------------------------------------------------------
 // Pylon
@@ -152,8 +160,12 @@ void Pylon::on_lever_pulled(Lever* const lever)
 {
     (void)lever;
 
+    const LgtSize lgt_before = lgt_size();
+
     is_activated_ = !is_activated_;
 
+    on_lgt_changed(lgt_before);
+
     nr_turns_active_ = 0;
 
     const bool is_seen_by_player =
@@ -185,18 +197,10 @@ void Pylon::on_lever_pulled(Lever* const lever)
     }
 }
 
-void Pylon::add_light_hook(bool light[map_w][map_h]) const
+LgtSize Pylon::lgt_size_hook() const
 {
-    if (is_activated_)
-    {
-        for (const P& d : dir_utils::dir_list_w_center)
-        {
-            const P p(pos_ + d);
-
-            light[p.x][p.y] = true;
-        }
-    }
- }
+    return is_activated_ ? LgtSize::small : LgtSize::none;
+}
 
 // -----------------------------------------------------------------------------
 // Pylon implementation
@@ -299,8 +303,6 @@ void PylonBurning::on_new_turn_activated()
         }
     }
 
-    int flood[map_w][map_h];
-
     const int nr_turns_active = pylon_->nr_turns_active();
 
     const int nr_turns_per_flood_step = 10;
@@ -316,22 +318,22 @@ void PylonBurning::on_new_turn_activated()
             flood_max_dist,
             (nr_turns_active / nr_turns_per_flood_step) + 1);
 
-    floodfill(pos_,
-              blocks_flood,
-              flood,
-              flood_dist);
+    flood_.run(pos_,
+               blocks_flood,
+               flood_dist);
 
-    for (int x = 0; x < map_w; ++x)
+    // NOTE: Copying the reached cells, in case hitting the features causes
+    //       another fill
+    const std::vector<P> flood_cells = flood_.reached();
+
+    for (const P& p : flood_cells)
     {
-        for (int y = 0; y < map_h; ++y)
+        if (p != pos_)
         {
-            if (flood[x][y] > 0)
-            {
-                map::cells[x][y].rigid->hit(
-                    1, // Doesn't matter
-                    DmgType::fire,
-                    DmgMethod::elemental);
-            }
+            map::cells[p.x][p.y].rigid->hit(
+                1, // Doesn't matter
+                DmgType::fire,
+                DmgMethod::elemental);
         }
     }
 
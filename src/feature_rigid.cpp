@@ -22,6 +22,7 @@
 #include "sound.hpp"
 #include "feature_door.hpp"
 #include "wham.hpp"
+#include "light_srcs.hpp"
 
 // -----------------------------------------------------------------------------
 // Rigid
@@ -124,7 +125,7 @@ void Rigid::on_new_turn()
 
         if (rnd::one_in(finish_burning_one_in_n))
         {
-            burn_state_ = BurnState::has_burned;
+            set_burn_state(BurnState::has_burned);
 
             if (on_finished_burning() == WasDestroyed::yes)
             {
@@ -194,7 +195,7 @@ void Rigid::try_start_burning(const bool is_msg_allowed)
             msg_log::add(str);
         }
 
-        burn_state_ = BurnState::burning;
+        set_burn_state(BurnState::burning);
     }
 }
 
@@ -430,22 +431,40 @@ void Rigid::clear_gore()
     is_bloody_ = false;
 }
 
-void Rigid::add_light(bool light[map_w][map_h]) const
+LgtSize Rigid::lgt_size() const
 {
     if (burn_state_ == BurnState::burning)
     {
-        for (const P& d : dir_utils::dir_list_w_center)
-        {
-            const P p(pos_ + d);
+        return LgtSize::small;
+    }
 
-            if (map::is_pos_inside_map(p, true))
-            {
-                light[p.x][p.y] = true;
-            }
-        }
+    return lgt_size_hook();
+}
+
+void Rigid::on_lgt_changed(const LgtSize lgt_before)
+{
+    const LgtSize lgt_after = lgt_size();
+
+    // NOTE: Rigids which are not (yet) on the map register their light when
+    //       they are put on the map
+    if ((lgt_after == lgt_before) ||
+        (map::cells[pos_.x][pos_.y].rigid != this))
+    {
+        return;
     }
 
-    add_light_hook(light);
+    light_srcs::remove(pos_, lgt_before);
+
+    light_srcs::add(pos_, lgt_after);
+}
+
+void Rigid::set_burn_state(const BurnState state)
+{
+    const LgtSize lgt_before = lgt_size();
+
+    burn_state_ = state;
+
+    on_lgt_changed(lgt_before);
 }
 
 // -----------------------------------------------------------------------------
@@ -1169,7 +1188,7 @@ void Stairs::bump(Actor& actor_bumping)
         switch (choice)
         {
         case 0:
-            map::player->pos = pos_;
+            map::player->set_pos(pos_);
 
             msg_log::clear();
 
@@ -1179,7 +1198,7 @@ void Stairs::bump(Actor& actor_bumping)
             break;
 
         case 1:
-            map::player->pos = pos_;
+            map::player->set_pos(pos_);
 
             saving::save_game();
 
@@ -2151,14 +2170,9 @@ void Brazier::on_hit(const int dmg,
     }
 }
 
-void Brazier::add_light_hook(bool light[map_w][map_h]) const
+LgtSize Brazier::lgt_size_hook() const
 {
-    for (const P& d : dir_utils::dir_list_w_center)
-    {
-        const P p(pos_ + d);
-
-        light[p.x][p.y] = true;
-    }
+    return LgtSize::small;
 }
 
 Clr Brazier::clr_default() const
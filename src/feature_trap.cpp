@@ -455,7 +455,7 @@ void Trap::disarm()
 
         if (rnd::one_in(trigger_one_in_n))
         {
-            map::player->pos = pos_;
+            map::player->set_pos(pos_);
 
             trigger_trap(map::player);
         }
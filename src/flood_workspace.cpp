@@ -0,0 +1,180 @@
+#include "flood_workspace.hpp"
+
+#include <algorithm>
+
+#include "init.hpp"
+
+FloodWorkspace::FloodWorkspace() :
+    stamp_nr_(0)
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            stamp_[x][y] = 0;
+            dist_[x][y] = 0;
+        }
+    }
+
+    reached_.reserve(nr_map_cells);
+}
+
+void FloodWorkspace::begin_fill()
+{
+    ++stamp_nr_;
+
+    // When the stamp number wraps around, old stamps could be mistaken for the
+    // current fill - so start over from a cleared buffer
+    if (stamp_nr_ == 0)
+    {
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                stamp_[x][y] = 0;
+            }
+        }
+
+        stamp_nr_ = 1;
+    }
+
+    reached_.clear();
+}
+
+void FloodWorkspace::run(const P& origin,
+                         const bool blocked[map_w][map_h],
+                         const int max_dist,
+                         const bool allow_diagonal,
+                         const R& area,
+                         const P& tgt)
+{
+    begin_fill();
+
+    stamp_[origin.x][origin.y] = stamp_nr_;
+    dist_[origin.x][origin.y] = 0;
+
+    reached_.push_back(origin);
+
+    if (origin == tgt)
+    {
+        return;
+    }
+
+    const R bounds(std::max(area.p0.x, 0),
+                   std::max(area.p0.y, 0),
+                   std::min(area.p1.x, map_w - 1),
+                   std::min(area.p1.y, map_h - 1));
+
+    for (size_t i = 0; i < reached_.size(); ++i)
+    {
+        const P p = reached_[i];
+
+        const int new_dist = dist_[p.x][p.y] + 1;
+
+        // NOTE: Cells are reached in order of distance, so no cells further
+        //       out can be within the limit
+        if (new_dist > max_dist)
+        {
+            return;
+        }
+
+        for (const P& d : dir_utils::dir_list)
+        {
+            if (!allow_diagonal && (d.x != 0) && (d.y != 0))
+            {
+                continue;
+            }
+
+            const P new_p(p + d);
+
+            if (!is_pos_inside(new_p, bounds) ||
+                (stamp_[new_p.x][new_p.y] == stamp_nr_))
+            {
+                continue;
+            }
+
+            const bool is_tgt = (new_p == tgt);
+
+            if (blocked[new_p.x][new_p.y] && !is_tgt)
+            {
+                continue;
+            }
+
+            stamp_[new_p.x][new_p.y] = stamp_nr_;
+            dist_[new_p.x][new_p.y] = new_dist;
+
+            reached_.push_back(new_p);
+
+            if (is_tgt)
+            {
+                return;
+            }
+        }
+    }
+}
+
+void FloodWorkspace::pathfind(const P& p0,
+                              const P& p1,
+                              const bool blocked[map_w][map_h],
+                              std::vector<P>& out,
+                              const bool allow_diagonal,
+                              const bool randomize_steps)
+{
+    out.clear();
+
+    if (p0 == p1)
+    {
+        return;
+    }
+
+    // Fill from the end of the path, so that the path can be walked from the
+    // start by always stepping to a cell closer to the end
+    run(p1,
+        blocked,
+        INT_MAX,
+        allow_diagonal,
+        R(1, 1, map_w - 2, map_h - 2),
+        p0);
+
+    if (!is_reached(p0))
+    {
+        return;
+    }
+
+    std::vector<P> steps;
+
+    P p(p0);
+
+    while (p != p1)
+    {
+        const int step_dist = dist_[p.x][p.y] - 1;
+
+        steps.clear();
+
+        for (const P& d : dir_utils::dir_list)
+        {
+            if (!allow_diagonal && (d.x != 0) && (d.y != 0))
+            {
+                continue;
+            }
+
+            const P step_p(p + d);
+
+            if (is_pos_inside(step_p, R(0, 0, map_w - 1, map_h - 1)) &&
+                is_reached(step_p) &&
+                (dist_[step_p.x][step_p.y] == step_dist))
+            {
+                steps.push_back(step_p);
+            }
+        }
+
+        ASSERT(!steps.empty());
+
+        p = randomize_steps ? rnd::element(steps) : steps.front();
+
+        out.push_back(p);
+    }
+
+    // Store the path from the end
+    std::reverse(begin(out), end(out));
+}
@@ -11,6 +11,63 @@
 namespace fov
 {
 
+namespace
+{
+
+//
+// The precalculated FOV lines to all cells in range, merged into a tree with
+// one node per distinct line prefix. Since the result for a cell only depends
+// on the cells of its line, walking the tree gives exactly the same result as
+// checking each cell separately with "check_cell", but each shared part of the
+// lines is only visited once, and whole subtrees are skipped behind walls.
+//
+// NOTE: The nodes are stored in depth first order, so the parent of a node is
+//       always before it, and its subtree is the range up to "subtree_end".
+//
+struct LineNode
+{
+    LineNode(const P& delta_, const int parent_) :
+        delta       (delta_),
+        parent      (parent_),
+        subtree_end (0),
+        is_tgt      (false) {}
+
+    P delta;
+    int parent;
+    int subtree_end;
+
+    // True if the line to this node's delta ends at this node
+    bool is_tgt;
+};
+
+std::vector<LineNode> line_tree_;
+
+// Darkness encountered on the line up to (and including) each node, not
+// considering if the target is lit (one entry per node, reused by each run)
+std::vector<char> drk_on_line_;
+
+// Appends the node and its subtree in depth first order
+void add_line_tree_nodes(const int node_idx,
+                         const int parent,
+                         const std::vector< std::vector<int> >& children,
+                         const std::vector<LineNode>& nodes)
+{
+    const int pos = (int)line_tree_.size();
+
+    line_tree_.push_back(nodes[node_idx]);
+
+    line_tree_[pos].parent = parent;
+
+    for (const int child_idx : children[node_idx])
+    {
+        add_line_tree_nodes(child_idx, pos, children, nodes);
+    }
+
+    line_tree_[pos].subtree_end = (int)line_tree_.size();
+}
+
+} // namespace
+
 R get_fov_rect(const P& p)
 {
     const int radi = fov_std_radi_int;
@@ -105,6 +162,75 @@ LosResult check_cell(const P& p0,
     return los_result;
 }
 
+void init()
+{
+    // Build the tree with the nodes in insertion order, then store it in depth
+    // first order
+    std::vector<LineNode> nodes;
+    std::vector< std::vector<int> > children;
+
+    nodes.push_back(LineNode(P(0, 0), -1));
+    children.push_back({});
+
+    const int radi = fov_std_radi_int;
+
+    for (int dx = -radi; dx <= radi; ++dx)
+    {
+        for (int dy = -radi; dy <= radi; ++dy)
+        {
+            const std::vector<P>* const line =
+                line_calc::fov_delta_line(P(dx, dy), fov_std_radi_db);
+
+            if (!line)
+            {
+                continue;
+            }
+
+            ASSERT(!line->empty() && (*line)[0] == P(0, 0));
+
+            int node_idx = 0;
+
+            for (size_t i = 1; i < line->size(); ++i)
+            {
+                const P& delta = (*line)[i];
+
+                int child_idx = -1;
+
+                for (const int idx : children[node_idx])
+                {
+                    if (nodes[idx].delta == delta)
+                    {
+                        child_idx = idx;
+                        break;
+                    }
+                }
+
+                if (child_idx == -1)
+                {
+                    child_idx = (int)nodes.size();
+
+                    nodes.push_back(LineNode(delta, node_idx));
+                    children.push_back({});
+
+                    children[node_idx].push_back(child_idx);
+                }
+
+                node_idx = child_idx;
+            }
+
+            ASSERT(nodes[node_idx].delta == P(dx, dy));
+
+            nodes[node_idx].is_tgt = true;
+        }
+    }
+
+    line_tree_.clear();
+
+    add_line_tree_nodes(0, -1, children, nodes);
+
+    drk_on_line_.assign(line_tree_.size(), false);
+}
+
 void run(const P& p0,
          const bool hard_blocked[map_w][map_h],
          LosResult out[map_w][map_h])
@@ -120,17 +246,86 @@ void run(const P& p0,
         }
     }
 
-    const R r = get_fov_rect(p0);
+    out[p0.x][p0.y].is_blocked_hard = false;
+
+    ASSERT(!line_tree_.empty());
+
+    const auto& planes = map::cell_planes;
+
+    const int nr_nodes = (int)line_tree_.size();
+
+    ASSERT(drk_on_line_.size() == line_tree_.size());
 
-    for (int x = r.p0.x; x <= r.p1.x; ++x)
+    // NOTE: The root node is the origin, which is already set
+    int node_idx = 1;
+
+    while (node_idx < nr_nodes)
     {
-        for (int y = r.p0.y; y <= r.p1.y; ++y)
+        const LineNode& node = line_tree_[node_idx];
+
+        const P p(p0 + node.delta);
+
+        // The lines only move away from the origin, so once a line has left
+        // the map, the rest of it is outside too
+        if (!map::is_pos_inside_map(p))
         {
-            out[x][y] = check_cell(p0, {x, y}, hard_blocked);
+            node_idx = node.subtree_end;
+            continue;
         }
-    }
 
-    out[p0.x][p0.y].is_blocked_hard = false;
+        const bool is_lit = planes.is_lit[p.x][p.y];
+
+        bool drk = drk_on_line_[node.parent];
+
+        // NOTE: Darkness is not checked for the first cell after the origin
+        if (node.parent != 0 && !drk && !is_lit)
+        {
+            const P pre_p(p0 + line_tree_[node.parent].delta);
+
+            drk =
+                planes.is_dark[p.x][p.y] ||
+                planes.is_dark[pre_p.x][pre_p.y];
+        }
+
+        drk_on_line_[node_idx] = drk;
+
+        if (node.is_tgt)
+        {
+            LosResult& los = out[p.x][p.y];
+
+            los.is_blocked_hard     = false;
+
+            // Lit targets are never blocked by darkness
+            los.is_blocked_by_drk   = drk && !is_lit;
+        }
+
+        if (!hard_blocked[p.x][p.y])
+        {
+            ++node_idx;
+            continue;
+        }
+
+        // All lines further through this cell are blocked. They are already
+        // set as blocked, but the darkness found so far is still reported.
+        if (drk)
+        {
+            for (int i = node_idx + 1; i < node.subtree_end; ++i)
+            {
+                const LineNode& blocked_node = line_tree_[i];
+
+                const P blocked_p(p0 + blocked_node.delta);
+
+                if (blocked_node.is_tgt &&
+                    map::is_pos_inside_map(blocked_p))
+                {
+                    out[blocked_p.x][blocked_p.y].is_blocked_by_drk =
+                        !planes.is_lit[blocked_p.x][blocked_p.y];
+                }
+            }
+        }
+
+        node_idx = node.subtree_end;
+    }
 }
 
 } // fov
@@ -1384,7 +1384,7 @@ void GameState::draw_map()
 
             render_data = &game::render_array[x][y];
 
-            auto& cell = map::cells[x][y];
+            auto cell = map::cells[x][y];
 
             if (cell.is_seen_by_player)
             {
@@ -1475,7 +1475,7 @@ void GameState::draw_map()
                 // Copy array to player memory (before living actors and mobile
                 // features)
                 // -------------------------------------------------------------
-                auto& cell = map::cells[x][y];
+                auto cell = map::cells[x][y];
 
                 cell.player_visual_memory = *render_data;
 
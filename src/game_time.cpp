@@ -1,6 +1,8 @@
 #include "game_time.hpp"
 
 #include <vector>
+#include <set>
+#include <algorithm>
 
 #include "init.hpp"
 #include "feature_rigid.hpp"
@@ -19,6 +21,7 @@
 #include "item.hpp"
 #include "saving.hpp"
 #include "msg_log.hpp"
+#include "light_srcs.hpp"
 
 namespace game_time
 {
@@ -31,17 +34,126 @@ bool is_magic_descend_nxt_std_turn;
 namespace
 {
 
-std::vector<ActorSpeed> turn_type_vector_;
+// Orders actors by the tick on which they act next. Actors acting on the same
+// tick act in the order they were added (i.e. the order of the actor vector).
+struct ActorSchedCmp
+{
+    bool operator()(const Actor* const a1, const Actor* const a2) const
+    {
+        if (a1->nxt_act_tick_ != a2->nxt_act_tick_)
+        {
+            return a1->nxt_act_tick_ < a2->nxt_act_tick_;
+        }
+
+        return a1->act_order_ < a2->act_order_;
+    }
+};
 
 const int ticks_per_turn_ = 20;
 
-int current_turn_type_pos_ = 0;
+// NOTE: An actor which has just acted waits "ticks_per_turn_" ticks at normal
+//       speed, and acts on the tick after that - so a standard turn is one
+//       tick longer than the delay.
+const int ticks_per_std_turn_ = ticks_per_turn_ + 1;
 
-size_t current_actor_idx_ = 0;
+// All actors waiting to act (the current actor is not included)
+std::set<Actor*, ActorSchedCmp> schedule_;
+
+Actor* current_actor_ = nullptr;
+
+int tick_nr_ = 0;
+
+int nxt_std_turn_tick_ = ticks_per_std_turn_;
+
+int nxt_act_order_ = 0;
 
 int turn_nr_ = 0;
 
-int std_turn_delay_ = ticks_per_turn_;
+// The actors (of any state) and mobs in each cell - these are kept in sync with
+// the actor and mob lists, so that cells can be looked up directly
+std::vector<Actor*> actors_at_pos_[map_w][map_h];
+std::vector<Mob*>   mobs_at_pos_[map_w][map_h];
+
+template<typename T>
+bool erase_from(std::vector<T*>& v, T* const element)
+{
+    for (auto it = begin(v); it != end(v); ++it)
+    {
+        if (*it == element)
+        {
+            v.erase(it);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void clear_pos_index()
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            actors_at_pos_[x][y].clear();
+            mobs_at_pos_[x][y]  .clear();
+        }
+    }
+}
+
+#ifndef NDEBUG
+// Checks that the per-cell lists contain exactly the actors and mobs of the
+// actor and mob lists which are in the cell
+void validate_pos_index(const P& p)
+{
+    const auto& cell_actors = actors_at_pos_[p.x][p.y];
+
+    size_t nr_actors_here = 0;
+
+    for (Actor* const actor : actors)
+    {
+        if (actor->pos == p)
+        {
+            ++nr_actors_here;
+
+            ASSERT(std::find(begin(cell_actors), end(cell_actors), actor) !=
+                   end(cell_actors));
+        }
+    }
+
+    ASSERT(nr_actors_here == cell_actors.size());
+
+    const auto& cell_mobs = mobs_at_pos_[p.x][p.y];
+
+    size_t nr_mobs_here = 0;
+
+    for (Mob* const mob : mobs)
+    {
+        if (mob->pos() == p)
+        {
+            ++nr_mobs_here;
+
+            ASSERT(std::find(begin(cell_mobs), end(cell_mobs), mob) !=
+                   end(cell_mobs));
+        }
+    }
+
+    ASSERT(nr_mobs_here == cell_mobs.size());
+}
+#endif // NDEBUG
+
+void unschedule(Actor* const actor)
+{
+    // NOTE: The ordering is based on the actor's scheduling values, so these
+    //       must not have been modified since the actor was inserted
+    schedule_.erase(actor);
+
+    if (actor == current_actor_)
+    {
+        current_actor_ = nullptr;
+    }
+}
 
 void run_std_turn_events()
 {
@@ -76,14 +188,13 @@ void run_std_turn_events()
                 map::player->tgt_ = nullptr;
             }
 
+            unschedule(actor);
+
+            erase_from(actors_at_pos_[actor->pos.x][actor->pos.y], actor);
+
             delete actor;
 
             it = actors.erase(it);
-
-            if (current_actor_idx_ >= actors.size())
-            {
-                current_actor_idx_ = 0;
-            }
         }
         else  // Actor is alive or a corpse
         {
@@ -179,23 +290,52 @@ void run_atomic_turn_events()
     update_light_map();
 }
 
+// Registers or unregisters the light of the mob, and lets the light sources
+// know if light may now be blocked differently (e.g. smoke)
+void on_mob_added_or_removed(const Mob& mob, const bool is_added)
+{
+    const P p = mob.pos();
+
+    if (is_added)
+    {
+        light_srcs::add(p, mob.lgt_size());
+    }
+    else // Removed
+    {
+        light_srcs::remove(p, mob.lgt_size());
+    }
+
+    if (!mob.is_los_passable())
+    {
+        light_srcs::on_los_blocking_changed(p);
+    }
+}
+
 } // namespace
 
 void init()
 {
-    current_turn_type_pos_ = 0;
-    current_actor_idx_ = 0;
+    schedule_.clear();
+    current_actor_ = nullptr;
+    tick_nr_ = 0;
+    nxt_std_turn_tick_ = ticks_per_std_turn_;
+    nxt_act_order_ = 0;
     turn_nr_ = 0;
-    std_turn_delay_ = ticks_per_turn_;
 
     actors.clear();
     mobs  .clear();
 
+    clear_pos_index();
+
     is_magic_descend_nxt_std_turn = false;
 }
 
 void cleanup()
 {
+    schedule_.clear();
+
+    current_actor_ = nullptr;
+
     for (Actor* a : actors)
     {
         delete a;
@@ -210,6 +350,8 @@ void cleanup()
 
     mobs.clear();
 
+    clear_pos_index();
+
     is_magic_descend_nxt_std_turn = false;
 }
 
@@ -230,20 +372,53 @@ int turn_nr()
 
 void mobs_at_pos(const P& p, std::vector<Mob*>& vector_ref)
 {
-    vector_ref.clear();
+    vector_ref = mobs_at_pos(p);
+}
 
-    for (auto* m : mobs)
+const std::vector<Mob*>& mobs_at_pos(const P& p)
+{
+#ifndef NDEBUG
+    validate_pos_index(p);
+#endif // NDEBUG
+
+    return mobs_at_pos_[p.x][p.y];
+}
+
+const std::vector<Actor*>& actors_at_pos(const P& p)
+{
+#ifndef NDEBUG
+    validate_pos_index(p);
+#endif // NDEBUG
+
+    return actors_at_pos_[p.x][p.y];
+}
+
+void on_actor_moved(Actor* const actor, const P& old_pos)
+{
+    // NOTE: Actors are positioned before they are added to the actor list, in
+    //       that case there is nothing to update
+    if (!map::is_pos_inside_map(old_pos) ||
+        !erase_from(actors_at_pos_[old_pos.x][old_pos.y], actor))
     {
-        if (m->pos() == p)
-        {
-            vector_ref.push_back(m);
-        }
+        return;
     }
+
+    const P& p = actor->pos;
+
+    ASSERT(map::is_pos_inside_map(p));
+
+    actors_at_pos_[p.x][p.y].push_back(actor);
 }
 
 void add_mob(Mob* const f)
 {
     mobs.push_back(f);
+
+    const P p = f->pos();
+
+    mobs_at_pos_[p.x][p.y].push_back(f);
+
+    on_mob_added_or_removed(*f, true);
 }
 
 void erase_mob(Mob* const f, const bool destroy_object)
@@ -252,6 +427,12 @@ void erase_mob(Mob* const f, const bool destroy_object)
     {
         if (*it == f)
         {
+            const P p = f->pos();
+
+            erase_from(mobs_at_pos_[p.x][p.y], f);
+
+            on_mob_added_or_removed(*f, false);
+
             if (destroy_object)
             {
                 delete f;
@@ -270,6 +451,12 @@ void erase_all_mobs()
 {
     for (auto* m : mobs)
     {
+        const P p = m->pos();
+
+        mobs_at_pos_[p.x][p.y].clear();
+
+        on_mob_added_or_removed(*m, false);
+
         delete m;
     }
 
@@ -303,11 +490,38 @@ void add_actor(Actor* actor)
 #endif // NDEBUG
 
     actors.push_back(actor);
+
+    actors_at_pos_[actor->pos.x][actor->pos.y].push_back(actor);
+
+    // The new actor acts on the current tick, after all actors added before it
+    actor->nxt_act_tick_ = tick_nr_;
+
+    actor->act_order_ = nxt_act_order_;
+
+    ++nxt_act_order_;
+
+    schedule_.insert(actor);
 }
 
-void reset_turn_type_and_actor_counters()
+void erase_actor(Actor* const actor)
 {
-    current_turn_type_pos_ = current_actor_idx_ = 0;
+    unschedule(actor);
+
+    for (auto it = begin(actors); it != end(actors); ++it)
+    {
+        if (*it == actor)
+        {
+            erase_from(actors_at_pos_[actor->pos.x][actor->pos.y], actor);
+
+            delete actor;
+
+            actors.erase(it);
+
+            return;
+        }
+    }
+
+    ASSERT(false);
 }
 
 void tick(const int speed_pct_diff)
@@ -325,56 +539,55 @@ void tick(const int speed_pct_diff)
         // number of actions
         delay_to_set = std::max(1, delay_to_set);
 
-        actor->delay_ = delay_to_set;
+        // The actor waits for the delay, and acts on the tick after that
+        actor->nxt_act_tick_ = tick_nr_ + delay_to_set + 1;
     }
 
+    schedule_.insert(actor);
+
+    current_actor_ = nullptr;
+
     actor->prop_handler().on_turn_end();
 
-    // Find next actor who can act
+    // Find next actor who can act - instead of counting down each actor tick by
+    // tick, we skip directly to the tick of the first actor in the schedule.
     while (true)
     {
-        if (actors.empty())
+        if (schedule_.empty())
         {
             return;
         }
 
-        ++current_actor_idx_;
+        Actor* const nxt_actor = *begin(schedule_);
+
+        ASSERT(nxt_actor->nxt_act_tick_ >= tick_nr_);
 
-        if (current_actor_idx_ == actors.size())
+        // New standard turn before the next actor acts?
+        if (nxt_std_turn_tick_ <= nxt_actor->nxt_act_tick_)
         {
-            // New standard turn?
-            if (std_turn_delay_ == 0)
-            {
-                // Increment the turn counter, and run standard turn events
-                // run_std_turn_events();
-                //
-                // NOTE: This will prune destroyed actors, which will decrease
-                //       the actor vector size.
-                //
-                run_std_turn_events();
-
-                std_turn_delay_ = ticks_per_turn_;
-            }
-            else
-            {
-                --std_turn_delay_;
-            }
+            tick_nr_ = nxt_std_turn_tick_;
 
-            current_actor_idx_ = 0;
+            nxt_std_turn_tick_ += ticks_per_std_turn_;
+
+            // Increment the turn counter, and run standard turn events
+            //
+            // NOTE: This will prune destroyed actors, and may add new actors
+            //       (or even travel to a new level), so the next actor must be
+            //       looked up again afterwards.
+            //
+            run_std_turn_events();
+
+            continue;
         }
 
-        actor = current_actor();
+        // Actor is ready to go
+        tick_nr_ = nxt_actor->nxt_act_tick_;
 
-        ASSERT(actor->delay_ >= 0);
+        schedule_.erase(begin(schedule_));
 
-        if (actor->delay_ == 0)
-        {
-            // Actor is ready to go
-            break;
-        }
+        current_actor_ = nxt_actor;
 
-        // Actor is still waiting
-        --actor->delay_;
+        break;
     }
 
     run_atomic_turn_events();
@@ -386,56 +599,34 @@ void tick(const int speed_pct_diff)
 
 void update_light_map()
 {
-    bool light[map_w][map_h];
-
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            map::cells[x][y].is_lit = light[x][y] = false;
-        }
-    }
-
-    // Do not add light on Leng
-    if (map_travel::map_type() == MapType::leng)
-    {
-        return;
-    }
+    // NOTE: Features register and unregister their light themselves (when they
+    //       are put on or removed from the map, and when their state changes),
+    //       only the actors are collected here
+    light_srcs::begin_update();
 
     for (const auto* const a : actors)
     {
-        a->add_light(light);
+        a->add_light();
     }
 
-    for (const auto* const m : mobs)
-    {
-        m->add_light(light);
-    }
-
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            map::cells[x][y].rigid->add_light(light);
-        }
-    }
-
-    // Copy the temp values to the real light map
-    // NOTE: Must be done separately - it cannot be done in the map loop above
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            map::cells[x][y].is_lit = light[x][y];
-        }
-    }
+    // Only the cells lit by added, moved or removed light sources are updated
+    light_srcs::end_update();
 }
 
 Actor* current_actor()
 {
-    ASSERT(current_actor_idx_ < actors.size());
+    if (!current_actor_)
+    {
+        // No actor has been picked from the schedule yet (new session, or the
+        // current actor was erased) - the first actor in the list acts first
+        ASSERT(!actors.empty());
+
+        current_actor_ = actors.front();
+
+        schedule_.erase(current_actor_);
+    }
 
-    Actor* const actor = actors[current_actor_idx_];
+    Actor* const actor = current_actor_;
 
     ASSERT(map::is_pos_inside_map(actor->pos));
 
@@ -8,6 +8,7 @@
 #include "io.hpp"
 #include "audio.hpp"
 #include "line_calc.hpp"
+#include "fov.hpp"
 #include "gods.hpp"
 #include "item_scroll.hpp"
 #include "item_potion.hpp"
@@ -58,6 +59,7 @@ void init_game()
     TRACE_FUNC_BEGIN;
     saving::init();
     line_calc::init();
+    fov::init();
     gods::init();
     map_templates::init();
     TRACE_FUNC_END;
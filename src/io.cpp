@@ -15,6 +15,7 @@
 #include "attack.hpp"
 #include "inventory.hpp"
 #include "sdl_base.hpp"
+#include "animation.hpp"
 #include "text_format.hpp"
 
 namespace io
@@ -47,20 +48,55 @@ std::vector<P> font_px_data_[font_nr_x_][font_nr_y_];
 std::vector<P> tile_contour_px_data_[tiles_nr_x_][tiles_nr_y_];
 std::vector<P> font_contour_px_data_[font_nr_x_][font_nr_y_];
 
+// Sheets with the font and tile images, used for blitting glyphs and tiles to
+// the screen. The image pixels are white, so that any color can be applied
+// with color modulation. The "contour" variants also contain the (black)
+// contour around the image. All other pixels are transparent (color keyed).
+SDL_Surface* font_atlas_srf_ = nullptr;
+SDL_Surface* font_contour_atlas_srf_ = nullptr;
+SDL_Surface* tile_atlas_srf_ = nullptr;
+SDL_Surface* tile_contour_atlas_srf_ = nullptr;
+
+// GPU rendering (see config::is_gpu_rendering). Everything is drawn by the
+// renderer on a target texture, which keeps its content between frames (so
+// the same per cell redrawing is used as for the screen surface). Glyphs,
+// tiles and solid rectangles are all drawn from one atlas texture, and are
+// queued up and submitted together.
+bool is_gpu_rendering_ = false;
+
+SDL_Texture* scr_target_texture_ = nullptr;
+SDL_Texture* atlas_texture_ = nullptr;
+SDL_Texture* main_menu_logo_texture_ = nullptr;
+SDL_Texture* skull_texture_ = nullptr;
+
+// Y position of each atlas surface in the atlas texture (in the same order as
+// "atlas_texture_srfs")
+int atlas_texture_y_[4] = {};
+
+// A white pixel in the atlas texture, used for drawing solid rectangles
+SDL_Rect atlas_texture_solid_rect_ = {0, 0, 1, 1};
+
+struct GpuQuad
+{
+    SDL_Rect src;
+    SDL_Rect dst;
+    Clr clr;
+};
+
+std::vector<GpuQuad> gpu_quads_;
+
 SDL_Event sdl_event_;
 
-// Pointer to function used for writing pixels on the screen (there are
-// different variants depending on bpp)
-void (*put_px_ptr_)(const SDL_Surface& srf,
-                    int pixel_x,
-                    int pixel_y,
-                    Uint32 px) = nullptr;
+} // namespace
 
 bool is_inited()
 {
     return sdl_window_;
 }
 
+namespace
+{
+
 Uint32 px(const SDL_Surface& srf,
           const int pixel_x,
           const int pixel_y)
@@ -100,81 +136,387 @@ Uint32 px(const SDL_Surface& srf,
     return -1;
 }
 
-void put_px8(const SDL_Surface& srf,
-             const int pixel_x,
-             const int pixel_y,
-             const Uint32 px)
+void flush_gpu_quads()
 {
-    // p is the address to the pixel we want to set
-    Uint8* const p =
-        (Uint8*)srf.pixels +
-        (pixel_y * srf.pitch) +
-        (pixel_x * bpp_);
+    if (gpu_quads_.empty())
+    {
+        return;
+    }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+    // Submit all quads in one draw call
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int> indices;
+
+    vertices.clear();
+    indices.clear();
+
+    int atlas_w = 0;
+    int atlas_h = 0;
+
+    SDL_QueryTexture(atlas_texture_, nullptr, nullptr, &atlas_w, &atlas_h);
+
+    for (const GpuQuad& quad : gpu_quads_)
+    {
+        const SDL_Color clr = {quad.clr.r, quad.clr.g, quad.clr.b, 255};
+
+        const float u0 = float(quad.src.x) / atlas_w;
+        const float v0 = float(quad.src.y) / atlas_h;
+        const float u1 = float(quad.src.x + quad.src.w) / atlas_w;
+        const float v1 = float(quad.src.y + quad.src.h) / atlas_h;
+
+        const float x0 = float(quad.dst.x);
+        const float y0 = float(quad.dst.y);
+        const float x1 = float(quad.dst.x + quad.dst.w);
+        const float y1 = float(quad.dst.y + quad.dst.h);
+
+        const int idx0 = (int)vertices.size();
+
+        vertices.push_back({{x0, y0}, clr, {u0, v0}});
+        vertices.push_back({{x1, y0}, clr, {u1, v0}});
+        vertices.push_back({{x1, y1}, clr, {u1, v1}});
+        vertices.push_back({{x0, y1}, clr, {u0, v1}});
+
+        for (const int i : {0, 1, 2, 2, 3, 0})
+        {
+            indices.push_back(idx0 + i);
+        }
+    }
+
+    SDL_RenderGeometry(sdl_renderer_,
+                       atlas_texture_,
+                       vertices.data(),
+                       (int)vertices.size(),
+                       indices.data(),
+                       (int)indices.size());
+
+#else // Older SDL versions, no geometry rendering
+
+    // NOTE: The renderer may still batch these (SDL 2.0.10 and later)
+    Clr current_clr = clr_white_lgt;
+
+    SDL_SetTextureColorMod(atlas_texture_, 255, 255, 255);
 
-    *p = px;
+    for (const GpuQuad& quad : gpu_quads_)
+    {
+        if (!is_clr_equal(quad.clr, current_clr))
+        {
+            SDL_SetTextureColorMod(atlas_texture_,
+                                   quad.clr.r,
+                                   quad.clr.g,
+                                   quad.clr.b);
+
+            current_clr = quad.clr;
+        }
+
+        SDL_RenderCopy(sdl_renderer_,
+                       atlas_texture_,
+                       &quad.src,
+                       &quad.dst);
+    }
+
+#endif // SDL_VERSION_ATLEAST
+
+    gpu_quads_.clear();
 }
 
-void put_px16(const SDL_Surface& srf,
-              const int pixel_x,
-              const int pixel_y,
-              const Uint32 px)
+void fill_px_rect(const SDL_Rect& sdl_rect, const Clr& clr)
 {
-    // p is the address to the pixel we want to set
-    Uint8* const p =
-        (Uint8*)srf.pixels +
-        (pixel_y * srf.pitch) +
-        (pixel_x * bpp_);
+    if (is_gpu_rendering_)
+    {
+        gpu_quads_.push_back({atlas_texture_solid_rect_, sdl_rect, clr});
+    }
+    else // Software rendering
+    {
+        SDL_Rect dst_rect = sdl_rect;
 
-    *(Uint16*)p = px;
+        SDL_FillRect(scr_srf_,
+                     &dst_rect,
+                     SDL_MapRGB(scr_srf_->format, clr.r, clr.g, clr.b));
+    }
 }
 
-void put_px24(const SDL_Surface& srf,
-              const int pixel_x,
-              const int pixel_y,
-              const Uint32 px)
+// What is known about the content of each screen cell. This is used for only
+// redrawing cells which changed since the previous frame, and for only
+// uploading the changed parts of the screen surface to the texture.
+//
+// A "frame" starts at each call to clear_screen(). Instead of clearing the
+// whole surface, each cell is cleared when it is first drawn in during a frame,
+// and cells which were not drawn in at all are cleared by update_screen().
+enum class CellContent
 {
-    // p is the address to the pixel we want to set
-    Uint8* const p =
-        (Uint8*)srf.pixels +
-        (pixel_y * srf.pitch) +
-        (pixel_x * bpp_);
+    empty,      // Cleared to black
+    glyph,      // A single glyph with a background color (see "ScrCell")
+    tile,       // A single tile with a background color (see "ScrCell")
+    unknown     // Anything else (text at pixel positions, boxes, pictures...)
+};
+
+struct ScrCell
+{
+    ScrCell() :
+        content         (CellContent::empty),
+        id              (0),
+        clr             (clr_black),
+        bg_clr          (clr_black),
+        frame_drawn     (-1),
+        is_dirty        (true) {}
+
+    CellContent content;
+
+    // Glyph or tile id (for the glyph and tile content types)
+    int id;
+
+    Clr clr;
+    Clr bg_clr;
+
+    // The frame in which this cell was last drawn in
+    int frame_drawn;
+
+    // Changed since the last upload to the screen texture
+    bool is_dirty;
+};
 
-    if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+ScrCell scr_cells_[screen_w][screen_h];
+
+int frame_nr_ = 0;
+
+// Set by request_redraw(), the redraw is then done before anything else is
+// drawn or the screen is presented
+bool is_redraw_requested_ = false;
+
+void run_requested_redraw()
+{
+    if (is_redraw_requested_)
     {
-        p[0] = (px >> 16) & 0xff;
-        p[1] = (px >> 8) & 0xff;
-        p[2] = px & 0xff;
+        // NOTE: The flag is reset by clear_screen(), before drawing the states
+        clear_screen();
+
+        states::draw();
     }
-    else // Little endian
+}
+
+void fill_scr_cell(const int x, const int y, const Clr& clr)
+{
+    const int cell_px_w = config::cell_px_w();
+    const int cell_px_h = config::cell_px_h();
+
+    const SDL_Rect sdl_rect =
     {
-        p[0] = px & 0xff;
-        p[1] = (px >> 8) & 0xff;
-        p[2] = (px >> 16) & 0xff;
+        x * cell_px_w,
+        y * cell_px_h,
+        cell_px_w,
+        cell_px_h
+    };
+
+    fill_px_rect(sdl_rect, clr);
+}
+
+// Must be called before drawing anything on the screen surface. Cells which are
+// drawn in for the first time in this frame are cleared first (as if the whole
+// screen was cleared by clear_screen).
+void touch_px_area(const P& px_pos, const P& px_dims)
+{
+    if (px_dims.x <= 0 || px_dims.y <= 0)
+    {
+        return;
+    }
+
+    run_requested_redraw();
+
+    const int cell_px_w = config::cell_px_w();
+    const int cell_px_h = config::cell_px_h();
+
+    const int x0 = std::max(0, px_pos.x / cell_px_w);
+    const int y0 = std::max(0, px_pos.y / cell_px_h);
+
+    const int x1 = std::min(screen_w - 1,
+                            (px_pos.x + px_dims.x - 1) / cell_px_w);
+
+    const int y1 = std::min(screen_h - 1,
+                            (px_pos.y + px_dims.y - 1) / cell_px_h);
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        for (int y = y0; y <= y1; ++y)
+        {
+            ScrCell& cell = scr_cells_[x][y];
+
+            if (cell.frame_drawn != frame_nr_)
+            {
+                if (cell.content != CellContent::empty)
+                {
+                    fill_scr_cell(x, y, clr_black);
+                }
+
+                cell.frame_drawn = frame_nr_;
+            }
+
+            cell.content    = CellContent::unknown;
+            cell.is_dirty   = true;
+        }
     }
 }
 
-void put_px32(const SDL_Surface& srf,
-              const int pixel_x,
-              const int pixel_y,
-              const Uint32 px)
+// Returns the screen cell at the given pixel position, if the position is
+// exactly at the corner of a cell (otherwise nullptr is returned)
+ScrCell* scr_cell_at_px(const P& px_pos)
 {
-    // p is the address to the pixel we want to set
-    Uint8* const p =
-        (Uint8*)srf.pixels +
-        (pixel_y * srf.pitch) +
-        (pixel_x * bpp_);
+    const int cell_px_w = config::cell_px_w();
+    const int cell_px_h = config::cell_px_h();
+
+    if ((px_pos.x < 0) || (px_pos.y < 0) ||
+        (px_pos.x % cell_px_w != 0) || (px_pos.y % cell_px_h != 0))
+    {
+        return nullptr;
+    }
+
+    const P p(px_pos.x / cell_px_w, px_pos.y / cell_px_h);
+
+    if ((p.x >= screen_w) || (p.y >= screen_h))
+    {
+        return nullptr;
+    }
+
+    return &scr_cells_[p.x][p.y];
+}
+
+// Checks if the screen cell at the given position already contains exactly
+// what is about to be drawn there (from the previous frame). In that case the
+// cell is kept as it is, and nothing needs to be drawn.
+bool try_keep_scr_cell(const P& px_pos,
+                       const CellContent content,
+                       const int id,
+                       const Clr& clr,
+                       const Clr& bg_clr)
+{
+    run_requested_redraw();
+
+    ScrCell* const cell = scr_cell_at_px(px_pos);
+
+    if (!cell ||
+        (cell->frame_drawn == frame_nr_) ||
+        (cell->content != content) ||
+        (cell->id != id) ||
+        !is_clr_equal(cell->clr, clr) ||
+        !is_clr_equal(cell->bg_clr, bg_clr))
+    {
+        return false;
+    }
+
+    cell->frame_drawn = frame_nr_;
+
+    return true;
+}
+
+// Called after drawing a glyph or tile covering an entire cell
+void set_scr_cell_content(const P& px_pos,
+                          const CellContent content,
+                          const int id,
+                          const Clr& clr,
+                          const Clr& bg_clr)
+{
+    ScrCell* const cell = scr_cell_at_px(px_pos);
+
+    if (cell)
+    {
+        cell->content   = content;
+        cell->id        = id;
+        cell->clr       = clr;
+        cell->bg_clr    = bg_clr;
+    }
+}
 
-    *(Uint32*)p = px;
+// Clears all cells which were not drawn in during this frame
+void clear_undrawn_scr_cells()
+{
+    for (int x = 0; x < screen_w; ++x)
+    {
+        for (int y = 0; y < screen_h; ++y)
+        {
+            ScrCell& cell = scr_cells_[x][y];
+
+            if ((cell.frame_drawn != frame_nr_) &&
+                (cell.content != CellContent::empty))
+            {
+                fill_scr_cell(x, y, clr_black);
+
+                cell.content    = CellContent::empty;
+                cell.is_dirty   = true;
+            }
+        }
+    }
+}
+
+// Uploads the dirty cells to the screen texture, merged into horizontal runs
+void upload_dirty_scr_cells()
+{
+    const int cell_px_w = config::cell_px_w();
+    const int cell_px_h = config::cell_px_h();
+
+    for (int y = 0; y < screen_h; ++y)
+    {
+        int x = 0;
+
+        while (x < screen_w)
+        {
+            if (!scr_cells_[x][y].is_dirty)
+            {
+                ++x;
+                continue;
+            }
+
+            const int run_x0 = x;
+
+            while ((x < screen_w) && scr_cells_[x][y].is_dirty)
+            {
+                scr_cells_[x][y].is_dirty = false;
+                ++x;
+            }
+
+            const SDL_Rect sdl_rect =
+            {
+                run_x0 * cell_px_w,
+                y * cell_px_h,
+                (x - run_x0) * cell_px_w,
+                cell_px_h
+            };
+
+            const Uint8* const px_data =
+                (const Uint8*)scr_srf_->pixels +
+                (sdl_rect.y * scr_srf_->pitch) +
+                (sdl_rect.x * bpp_);
+
+            SDL_UpdateTexture(scr_texture_,
+                              &sdl_rect,
+                              px_data,
+                              scr_srf_->pitch);
+        }
+    }
 }
 
-void blit_surface(SDL_Surface& srf, const P& px_pos)
+void blit_picture(SDL_Surface& srf,
+                  SDL_Texture* const texture,
+                  const P& px_pos)
 {
+    touch_px_area(px_pos, P(srf.w, srf.h));
+
     SDL_Rect dst_rect
     {
         px_pos.x, px_pos.y, srf.w, srf.h
     };
 
-    SDL_BlitSurface(&srf, nullptr, scr_srf_, &dst_rect);
+    if (is_gpu_rendering_)
+    {
+        // Draw everything queued up so far first, to keep the drawing order
+        flush_gpu_quads();
+
+        SDL_RenderCopy(sdl_renderer_, texture, nullptr, &dst_rect);
+    }
+    else // Software rendering
+    {
+        SDL_BlitSurface(&srf, nullptr, scr_srf_, &dst_rect);
+    }
 }
 
 void load_pictures()
@@ -356,56 +698,318 @@ void load_contours(const std::vector<P>* base,
     TRACE_FUNC_END;
 }
 
-void put_pixels_on_scr(const std::vector<P> px_data,
-                       /*const P& sheet_pos,*/
-                       const P& scr_px_pos,
-                       const Clr& clr)
+SDL_Surface* mk_atlas_srf(const std::vector<P>* px_data,
+                          const std::vector<P>* contour_px_data,
+                          const int nr_x,
+                          const int nr_y)
+{
+    TRACE_FUNC_BEGIN;
+
+    const int cell_w = config::cell_px_w();
+    const int cell_h = config::cell_px_h();
+
+    SDL_Surface* const srf = SDL_CreateRGBSurface(0,
+                                                  nr_x * cell_w,
+                                                  nr_y * cell_h,
+                                                  screen_bpp,
+                                                  0x00FF0000,
+                                                  0x0000FF00,
+                                                  0x000000FF,
+                                                  0xFF000000);
+
+    if (!srf)
+    {
+        TRACE << "Failed to create atlas surface" << std::endl;
+        ASSERT(false);
+        return nullptr;
+    }
+
+    const Uint32 key_clr        = SDL_MapRGB(srf->format, 255,   0, 255);
+    const Uint32 img_clr        = SDL_MapRGB(srf->format, 255, 255, 255);
+    const Uint32 contour_clr    = SDL_MapRGB(srf->format,   0,   0,   0);
+
+    SDL_FillRect(srf, nullptr, key_clr);
+
+    // NOTE: All pixels are opaque, so there is no need for alpha blending
+    SDL_SetSurfaceBlendMode(srf, SDL_BLENDMODE_NONE);
+
+    SDL_SetColorKey(srf, SDL_TRUE, key_clr);
+
+    auto put_px = [srf](const P& p, const Uint32 clr)
+    {
+        SDL_Rect sdl_rect = {p.x, p.y, 1, 1};
+
+        SDL_FillRect(srf, &sdl_rect, clr);
+    };
+
+    for (int x = 0; x < nr_x; ++x)
+    {
+        for (int y = 0; y < nr_y; ++y)
+        {
+            const int offset = (x * nr_y) + y;
+
+            const P sheet_px_pos(x * cell_w, y * cell_h);
+
+            for (const P& p : *(px_data + offset))
+            {
+                put_px(sheet_px_pos + p, img_clr);
+            }
+
+            if (contour_px_data)
+            {
+                for (const P& p : *(contour_px_data + offset))
+                {
+                    put_px(sheet_px_pos + p, contour_clr);
+                }
+            }
+        }
+    }
+
+    TRACE_FUNC_END;
+
+    return srf;
+}
+
+void free_srf(SDL_Surface*& srf)
+{
+    if (srf)
+    {
+        SDL_FreeSurface(srf);
+        srf = nullptr;
+    }
+}
+
+void destroy_texture(SDL_Texture*& texture)
+{
+    if (texture)
+    {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
+
+std::vector<SDL_Surface*> atlas_texture_srfs()
+{
+    return
+    {
+        font_atlas_srf_,
+        font_contour_atlas_srf_,
+        tile_atlas_srf_,
+        tile_contour_atlas_srf_
+    };
+}
+
+// Creates one texture containing all atlas surfaces stacked vertically, with
+// a solid white area at the bottom. Returns false on failure.
+bool mk_atlas_texture()
+{
+    TRACE_FUNC_BEGIN;
+
+    const int cell_w = config::cell_px_w();
+    const int cell_h = config::cell_px_h();
+
+    const auto srfs = atlas_texture_srfs();
+
+    int w = cell_w;
+    int h = cell_h;
+
+    for (const SDL_Surface* const srf : srfs)
+    {
+        if (srf)
+        {
+            w = std::max(w, srf->w);
+            h += srf->h;
+        }
+    }
+
+    SDL_Surface* const atlas_srf = SDL_CreateRGBSurface(0,
+                                                        w,
+                                                        h,
+                                                        screen_bpp,
+                                                        0x00FF0000,
+                                                        0x0000FF00,
+                                                        0x000000FF,
+                                                        0xFF000000);
+
+    if (!atlas_srf)
+    {
+        TRACE << "Failed to create atlas surface" << std::endl;
+        return false;
+    }
+
+    const Uint32 key_clr = SDL_MapRGB(atlas_srf->format, 255, 0, 255);
+
+    SDL_FillRect(atlas_srf, nullptr, key_clr);
+
+    SDL_SetColorKey(atlas_srf, SDL_TRUE, key_clr);
+
+    int y = 0;
+
+    for (size_t i = 0; i < srfs.size(); ++i)
+    {
+        SDL_Surface* const srf = srfs[i];
+
+        atlas_texture_y_[i] = y;
+
+        if (srf)
+        {
+            SDL_Rect dst_rect = {0, y, srf->w, srf->h};
+
+            SDL_SetSurfaceColorMod(srf, 255, 255, 255);
+
+            SDL_BlitSurface(srf, nullptr, atlas_srf, &dst_rect);
+
+            y += srf->h;
+        }
+    }
+
+    SDL_Rect solid_rect = {0, y, cell_w, cell_h};
+
+    SDL_FillRect(atlas_srf,
+                 &solid_rect,
+                 SDL_MapRGB(atlas_srf->format, 255, 255, 255));
+
+    // NOTE: The center pixel is used, so that filtering never mixes in any
+    //       neighbouring pixels
+    atlas_texture_solid_rect_ = {cell_w / 2, y + (cell_h / 2), 1, 1};
+
+    // NOTE: The color key is converted to transparency
+    atlas_texture_ = SDL_CreateTextureFromSurface(sdl_renderer_, atlas_srf);
+
+    SDL_FreeSurface(atlas_srf);
+
+    if (!atlas_texture_)
+    {
+        TRACE << "Failed to create atlas texture" << std::endl;
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(atlas_texture_, SDL_BLENDMODE_BLEND);
+
+    TRACE_FUNC_END;
+
+    return true;
+}
+
+// Sets up everything needed for GPU rendering, returns false if not supported
+bool init_gpu_rendering()
 {
-    const int px_clr = SDL_MapRGB(scr_srf_->format,
-                                  clr.r,
-                                  clr.g,
-                                  clr.b);
+    TRACE_FUNC_BEGIN;
+
+    SDL_RendererInfo info;
 
-    for (const P& p_relative : px_data)
+    SDL_GetRendererInfo(sdl_renderer_, &info);
+
+    if (!(info.flags & SDL_RENDERER_ACCELERATED) ||
+        !(info.flags & SDL_RENDERER_TARGETTEXTURE))
     {
-        const int scr_px_x = scr_px_pos.x + p_relative.x;
-        const int scr_px_y = scr_px_pos.y + p_relative.y;
+        TRACE << "Renderer does not support GPU rendering" << std::endl;
+        return false;
+    }
 
-        put_px_ptr_(*scr_srf_,
-                    scr_px_x,
-                    scr_px_y,
-                    px_clr);
+    scr_target_texture_ = SDL_CreateTexture(sdl_renderer_,
+                                            SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_TARGET,
+                                            config::scr_px_w(),
+                                            config::scr_px_h());
+
+    if (!scr_target_texture_ || !mk_atlas_texture())
+    {
+        return false;
     }
+
+    if (main_menu_logo_srf_)
+    {
+        main_menu_logo_texture_ =
+            SDL_CreateTextureFromSurface(sdl_renderer_, main_menu_logo_srf_);
+    }
+
+    if (skull_srf_)
+    {
+        skull_texture_ =
+            SDL_CreateTextureFromSurface(sdl_renderer_, skull_srf_);
+    }
+
+    SDL_SetRenderTarget(sdl_renderer_, scr_target_texture_);
+
+    SDL_SetRenderDrawColor(sdl_renderer_, 0, 0, 0, 255);
+
+    SDL_RenderClear(sdl_renderer_);
+
+    TRACE_FUNC_END;
+
+    return true;
 }
 
-void put_pixels_on_scr_for_tile(const TileId tile,
-                                const P& scr_px_pos,
-                                const Clr& clr)
+void cleanup_gpu_rendering()
 {
-    const P sheet_pos(art::tile_pos(tile));
+    gpu_quads_.clear();
 
-    const auto& pixel_data =
-        tile_px_data_[sheet_pos.x][sheet_pos.y];
+    if (sdl_renderer_)
+    {
+        SDL_SetRenderTarget(sdl_renderer_, nullptr);
+    }
 
-    put_pixels_on_scr(pixel_data,
-                      /*art::tile_pos(tile),*/
-                      scr_px_pos,
-                      clr);
+    destroy_texture(scr_target_texture_);
+    destroy_texture(atlas_texture_);
+    destroy_texture(main_menu_logo_texture_);
+    destroy_texture(skull_texture_);
+
+    is_gpu_rendering_ = false;
 }
 
-void put_pixels_on_scr_for_glyph(const char glyph,
-                                 const P& scr_px_pos,
-                                 const Clr& clr)
+void blit_atlas_cell(SDL_Surface* const atlas_srf,
+                     const P& sheet_pos,
+                     const P& scr_px_pos,
+                     const Clr& clr)
 {
-    const P sheet_pos(art::glyph_pos(glyph));
+    // NOTE: The tile atlases are only created in tiles mode
+    if (!atlas_srf)
+    {
+        return;
+    }
+
+    const P cell_dims(config::cell_px_w(), config::cell_px_h());
+
+    touch_px_area(scr_px_pos, cell_dims);
 
-    const auto& pixel_data =
-        font_px_data_[sheet_pos.x][sheet_pos.y];
+    SDL_Rect src_rect =
+    {
+        sheet_pos.x * cell_dims.x,
+        sheet_pos.y * cell_dims.y,
+        cell_dims.x,
+        cell_dims.y
+    };
+
+    SDL_Rect dst_rect =
+    {
+        scr_px_pos.x,
+        scr_px_pos.y,
+        cell_dims.x,
+        cell_dims.y
+    };
+
+    if (is_gpu_rendering_)
+    {
+        const auto srfs = atlas_texture_srfs();
 
-    put_pixels_on_scr(pixel_data,
-                      /*art::glyph_pos(glyph),*/
-                      scr_px_pos,
-                      clr);
+        for (size_t i = 0; i < srfs.size(); ++i)
+        {
+            if (srfs[i] == atlas_srf)
+            {
+                src_rect.y += atlas_texture_y_[i];
+                break;
+            }
+        }
+
+        gpu_quads_.push_back({src_rect, dst_rect, clr});
+    }
+    else // Software rendering
+    {
+        SDL_SetSurfaceColorMod(atlas_srf, clr.r, clr.g, clr.b);
+
+        SDL_BlitSurface(atlas_srf, &src_rect, scr_srf_, &dst_rect);
+    }
 }
 
 /*
@@ -442,30 +1046,39 @@ void draw_glyph_at_px(const char glyph,
                       const bool draw_bg_clr,
                       const Clr& bg_clr = clr_black)
 {
+    if (draw_bg_clr &&
+        try_keep_scr_cell(px_pos, CellContent::glyph, glyph, clr, bg_clr))
+    {
+        return;
+    }
+
     if (draw_bg_clr)
     {
         const P cell_dims(config::cell_px_w(), config::cell_px_h());
 
         draw_rectangle_solid(px_pos, cell_dims, bg_clr);
+    }
 
-        // Draw contour if neither the foreground nor background is black
-        if (!is_clr_equal(clr, clr_black) &&
-            !is_clr_equal(bg_clr, clr_black))
-        {
-            const P glyph_pos(art::glyph_pos(glyph));
+    // Draw contour if neither the foreground nor background is black
+    const bool draw_contour =
+        draw_bg_clr &&
+        !is_clr_equal(clr, clr_black) &&
+        !is_clr_equal(bg_clr, clr_black);
 
-            const auto& contour_px_data =
-                font_contour_px_data_[glyph_pos.x][glyph_pos.y];
+    SDL_Surface* const atlas_srf =
+        draw_contour ?
+        font_contour_atlas_srf_ :
+        font_atlas_srf_;
 
-            put_pixels_on_scr(contour_px_data,
-                              px_pos,
-                              clr_black);
-        }
-    }
+    blit_atlas_cell(atlas_srf,
+                    art::glyph_pos(glyph),
+                    px_pos,
+                    clr);
 
-    put_pixels_on_scr_for_glyph(glyph,
-                                px_pos,
-                                clr);
+    if (draw_bg_clr)
+    {
+        set_scr_cell_content(px_pos, CellContent::glyph, glyph, clr, bg_clr);
+    }
 }
 
 } // namespace
@@ -509,9 +1122,21 @@ void init()
         ASSERT(false);
     }
 
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+#endif // SDL_VERSION_ATLEAST
+
     sdl_renderer_ = SDL_CreateRenderer(sdl_window_,
                                        -1,
-                                       SDL_RENDERER_ACCELERATED);
+                                       SDL_RENDERER_ACCELERATED |
+                                       SDL_RENDERER_TARGETTEXTURE);
+
+    if (!sdl_renderer_)
+    {
+        sdl_renderer_ = SDL_CreateRenderer(sdl_window_,
+                                           -1,
+                                           SDL_RENDERER_ACCELERATED);
+    }
 
     if (!sdl_renderer_)
     {
@@ -542,41 +1167,13 @@ void init()
 
     bpp_ = scr_srf_->format->BytesPerPixel;
 
-    switch (bpp_)
+    // The new surface is all black, but nothing is uploaded to the texture yet
+    for (int x = 0; x < screen_w; ++x)
     {
-    case 1:
-        put_px_ptr_ = &put_px8;
-        break;
-
-    case 2:
-        put_px_ptr_ = &put_px16;
-        break;
-
-    case 3:
-        put_px_ptr_ = &put_px24;
-        break;
-
-    case 4:
-        put_px_ptr_ = &put_px32;
-        break;
-
-    default:
-        TRACE << "Bad bpp: " << bpp_ << std::endl;
-
-        ASSERT(false);
-        break;
-    }
-
-    scr_texture_ = SDL_CreateTexture(sdl_renderer_,
-                                     SDL_PIXELFORMAT_ARGB8888,
-                                     SDL_TEXTUREACCESS_STREAMING,
-                                     scr_px_w,
-                                     scr_px_h);
-
-    if (!scr_texture_)
-    {
-        TRACE << "Failed to create screen texture" << std::endl;
-        ASSERT(false);
+        for (int y = 0; y < screen_h; ++y)
+        {
+            scr_cells_[x][y] = ScrCell();
+        }
     }
 
     load_font();
@@ -592,6 +1189,18 @@ void init()
             tiles_nr_x_,
             tiles_nr_y_,
             reinterpret_cast<std::vector<P>*>(tile_contour_px_data_));
+
+        tile_atlas_srf_ = mk_atlas_srf(
+            reinterpret_cast<const std::vector<P>*>(tile_px_data_),
+            nullptr,
+            tiles_nr_x_,
+            tiles_nr_y_);
+
+        tile_contour_atlas_srf_ = mk_atlas_srf(
+            reinterpret_cast<const std::vector<P>*>(tile_px_data_),
+            reinterpret_cast<const std::vector<P>*>(tile_contour_px_data_),
+            tiles_nr_x_,
+            tiles_nr_y_);
     }
 
     load_contours(
@@ -600,6 +1209,45 @@ void init()
         font_nr_y_,
         reinterpret_cast<std::vector<P>*>(font_contour_px_data_));
 
+    font_atlas_srf_ = mk_atlas_srf(
+        reinterpret_cast<const std::vector<P>*>(font_px_data_),
+        nullptr,
+        font_nr_x_,
+        font_nr_y_);
+
+    font_contour_atlas_srf_ = mk_atlas_srf(
+        reinterpret_cast<const std::vector<P>*>(font_px_data_),
+        reinterpret_cast<const std::vector<P>*>(font_contour_px_data_),
+        font_nr_x_,
+        font_nr_y_);
+
+    if (config::is_gpu_rendering())
+    {
+        is_gpu_rendering_ = init_gpu_rendering();
+
+        if (!is_gpu_rendering_)
+        {
+            TRACE << "Falling back to software rendering" << std::endl;
+
+            cleanup_gpu_rendering();
+        }
+    }
+
+    if (!is_gpu_rendering_)
+    {
+        scr_texture_ = SDL_CreateTexture(sdl_renderer_,
+                                         SDL_PIXELFORMAT_ARGB8888,
+                                         SDL_TEXTUREACCESS_STREAMING,
+                                         scr_px_w,
+                                         scr_px_h);
+
+        if (!scr_texture_)
+        {
+            TRACE << "Failed to create screen texture" << std::endl;
+            ASSERT(false);
+        }
+    }
+
     TRACE_FUNC_END;
 }
 
@@ -607,6 +1255,11 @@ void cleanup()
 {
     TRACE_FUNC_BEGIN;
 
+    // NOTE: Textures must be destroyed before the renderer
+    cleanup_gpu_rendering();
+
+    destroy_texture(scr_texture_);
+
     if (sdl_renderer_)
     {
         SDL_DestroyRenderer(sdl_renderer_);
@@ -619,12 +1272,6 @@ void cleanup()
         sdl_window_ = nullptr;
     }
 
-    if (scr_texture_)
-    {
-        SDL_DestroyTexture(scr_texture_);
-        scr_texture_ = nullptr;
-    }
-
     if (scr_srf_)
     {
         SDL_FreeSurface(scr_srf_);
@@ -643,6 +1290,11 @@ void cleanup()
         skull_srf_ = nullptr;
     }
 
+    free_srf(font_atlas_srf_);
+    free_srf(font_contour_atlas_srf_);
+    free_srf(tile_atlas_srf_);
+    free_srf(tile_contour_atlas_srf_);
+
     TRACE_FUNC_END;
 }
 
@@ -650,30 +1302,58 @@ void update_screen()
 {
     if (is_inited())
     {
-        SDL_UpdateTexture(scr_texture_,
-                          nullptr,
-                          scr_srf_->pixels,
-                          scr_srf_->pitch);
+        run_requested_redraw();
 
-        SDL_RenderCopy(sdl_renderer_,
-                       scr_texture_,
-                       nullptr,
-                       nullptr);
+        clear_undrawn_scr_cells();
+
+        if (is_gpu_rendering_)
+        {
+            flush_gpu_quads();
+
+            // NOTE: The target texture keeps the screen content, so only the
+            //       changed cells have been redrawn - nothing is uploaded
+            SDL_SetRenderTarget(sdl_renderer_, nullptr);
+
+            SDL_RenderCopy(sdl_renderer_,
+                           scr_target_texture_,
+                           nullptr,
+                           nullptr);
+
+            SDL_RenderPresent(sdl_renderer_);
 
-        SDL_RenderPresent(sdl_renderer_);
+            SDL_SetRenderTarget(sdl_renderer_, scr_target_texture_);
+        }
+        else // Software rendering
+        {
+            upload_dirty_scr_cells();
+
+            SDL_RenderCopy(sdl_renderer_,
+                           scr_texture_,
+                           nullptr,
+                           nullptr);
+
+            SDL_RenderPresent(sdl_renderer_);
+        }
     }
 }
 
 void clear_screen()
 {
+    // Anything drawn by a requested redraw would be cleared now anyway
+    is_redraw_requested_ = false;
+
     if (is_inited())
     {
-        SDL_FillRect(scr_srf_,
-                     nullptr,
-                     SDL_MapRGB(scr_srf_->format, 0, 0, 0));
+        // NOTE: The cells are cleared lazily (see "touch_px_area")
+        ++frame_nr_;
     }
 }
 
+void request_redraw()
+{
+    is_redraw_requested_ = true;
+}
+
 void draw_main_menu_logo(const int y_pos)
 {
     if (is_inited())
@@ -684,7 +1364,7 @@ void draw_main_menu_logo(const int y_pos)
 
         const P px_pos((scr_px_w - logo_px_h) / 2, cell_px_h * y_pos);
 
-        blit_surface(*main_menu_logo_srf_, px_pos);
+        blit_picture(*main_menu_logo_srf_, main_menu_logo_texture_, px_pos);
     }
 }
 
@@ -697,7 +1377,7 @@ void draw_skull(const P& p)
 
         const P px_pos(p * P(cell_px_w, cell_px_h));
 
-        blit_surface(*skull_srf_, px_pos);
+        blit_picture(*skull_srf_, skull_texture_, px_pos);
     }
 }
 
@@ -709,113 +1389,56 @@ void draw_blast_at_field(const P& center_pos,
 {
     TRACE_FUNC_BEGIN;
 
-    if (!is_inited())
+    AnimScript script;
+
+    if (!script.is_recording())
     {
         TRACE_FUNC_END;
 
         return;
     }
 
-    states::draw();
+    for (int i = 0; i < 2; ++i)
+    {
+        script.add_frame(config::delay_explosion() / 2);
 
-    bool is_any_blast_rendered = false;
+        const TileId tile = (i == 0) ? TileId::blast1 : TileId::blast2;
 
-    P pos;
+        P pos;
 
-    for (pos.y = std::max(1, center_pos.y - radius);
-         pos.y <= std::min(map_h - 2, center_pos.y + radius);
-         pos.y++)
-    {
-        for (pos.x = std::max(1, center_pos.x - radius);
-             pos.x <= std::min(map_w - 2, center_pos.x + radius);
-             pos.x++)
+        for (pos.y = std::max(1, center_pos.y - radius);
+             pos.y <= std::min(map_h - 2, center_pos.y + radius);
+             pos.y++)
         {
-            if (!forbidden_cells[pos.x][pos.y])
+            for (pos.x = std::max(1, center_pos.x - radius);
+                 pos.x <= std::min(map_w - 2, center_pos.x + radius);
+                 pos.x++)
             {
-                const bool is_outer =
-                    pos.x == center_pos.x - radius ||
-                    pos.x == center_pos.x + radius ||
-                    pos.y == center_pos.y - radius ||
-                    pos.y == center_pos.y + radius;
+                if (!forbidden_cells[pos.x][pos.y])
+                {
+                    const bool is_outer =
+                        pos.x == center_pos.x - radius ||
+                        pos.x == center_pos.x + radius ||
+                        pos.y == center_pos.y - radius ||
+                        pos.y == center_pos.y + radius;
 
-                const Clr clr = is_outer ? clr_outer : clr_inner;
+                    const Clr clr = is_outer ? clr_outer : clr_inner;
 
-                if (config::is_tiles_mode())
-                {
-                    draw_tile(TileId::blast1,
-                              Panel::map,
-                              pos,
-                              clr,
-                              clr_black);
-                }
-                else // Text mode
-                {
-                    draw_glyph('*',
-                               Panel::map,
-                               pos,
-                               clr,
-                               true,
-                               clr_black);
+                    script.add_cell(pos, tile, '*', clr);
                 }
-
-                is_any_blast_rendered = true;
             }
         }
-    }
-
-    update_screen();
-
-    if (is_any_blast_rendered)
-    {
-        sdl_base::sleep(config::delay_explosion() / 2);
-    }
 
-    for (pos.y = std::max(1, center_pos.y - radius);
-         pos.y <= std::min(map_h - 2, center_pos.y + radius);
-         pos.y++)
-    {
-        for (pos.x = std::max(1, center_pos.x - radius);
-             pos.x <= std::min(map_w - 2, center_pos.x + radius);
-             pos.x++)
+        // Nothing rendered, no need to wait
+        if (script.frames().back().cells.empty())
         {
-            if (!forbidden_cells[pos.x][pos.y])
-            {
-                const bool is_outer =
-                    pos.x == center_pos.x - radius ||
-                    pos.x == center_pos.x + radius ||
-                    pos.y == center_pos.y - radius ||
-                    pos.y == center_pos.y + radius;
+            TRACE_FUNC_END;
 
-                const Clr clr =
-                    is_outer ? clr_outer : clr_inner;
-
-                if (config::is_tiles_mode())
-                {
-                    draw_tile(TileId::blast2,
-                              Panel::map,
-                              pos,
-                              clr,
-                              clr_black);
-                }
-                else // Text mode
-                {
-                    draw_glyph('*',
-                               Panel::map,
-                               pos,
-                               clr,
-                               true,
-                               clr_black);
-                }
-            }
+            return;
         }
     }
 
-    update_screen();
-
-    if (is_any_blast_rendered)
-    {
-        sdl_base::sleep(config::delay_explosion() / 2);
-    }
+    anim::play(script);
 
     TRACE_FUNC_END;
 }
@@ -824,55 +1447,11 @@ void draw_blast_at_cells(const std::vector<P>& positions, const Clr& clr)
 {
     TRACE_FUNC_BEGIN;
 
-    if (!is_inited())
-    {
-        TRACE_FUNC_END;
-
-        return;
-    }
-
-    states::draw();
-
-    for (const P& pos : positions)
-    {
-        if (config::is_tiles_mode())
-        {
-            draw_tile(TileId::blast1, Panel::map, pos, clr, clr_black);
-        }
-        else
-        {
-            draw_glyph('*', Panel::map, pos, clr, true, clr_black);
-        }
-    }
-
-    update_screen();
+    AnimScript script;
 
-    sdl_base::sleep(config::delay_explosion() / 2);
+    script.add_blast(positions, clr, config::delay_explosion());
 
-    for (const P& pos : positions)
-    {
-        if (config::is_tiles_mode())
-        {
-            draw_tile(TileId::blast2,
-                      Panel::map,
-                      pos,
-                      clr,
-                      clr_black);
-        }
-        else // Text mode
-        {
-            draw_glyph('*',
-                       Panel::map,
-                       pos,
-                       clr,
-                       true,
-                       clr_black);
-        }
-    }
-
-    update_screen();
-
-    sdl_base::sleep(config::delay_explosion() / 2);
+    anim::play(script);
 
     TRACE_FUNC_END;
 }
@@ -928,27 +1507,31 @@ void draw_tile(const TileId tile,
 
     const P px_pos = px_pos_for_cell_in_panel(panel, pos);
 
+    if (try_keep_scr_cell(px_pos, CellContent::tile, (int)tile, clr, bg_clr))
+    {
+        return;
+    }
+
     const P cell_dims(config::cell_px_w(), config::cell_px_h());
 
     draw_rectangle_solid(px_pos, cell_dims, bg_clr);
 
     // Draw contour if neither the foreground nor background is black
-    if (!is_clr_equal(clr, clr_black) &&
-        !is_clr_equal(bg_clr, clr_black))
-    {
-        const P tile_pos(art::tile_pos(tile));
+    const bool draw_contour =
+        !is_clr_equal(clr, clr_black) &&
+        !is_clr_equal(bg_clr, clr_black);
 
-        const auto& contour_px_data =
-            tile_contour_px_data_[tile_pos.x][tile_pos.y];
+    SDL_Surface* const atlas_srf =
+        draw_contour ?
+        tile_contour_atlas_srf_ :
+        tile_atlas_srf_;
 
-        put_pixels_on_scr(contour_px_data,
-                          px_pos,
-                          clr_black);
-    }
+    blit_atlas_cell(atlas_srf,
+                    art::tile_pos(tile),
+                    px_pos,
+                    clr);
 
-    put_pixels_on_scr_for_tile(tile,
-                               px_pos,
-                               clr);
+    set_scr_cell_content(px_pos, CellContent::tile, (int)tile, clr, bg_clr);
 }
 
 void draw_glyph(const char glyph,
@@ -1053,6 +1636,8 @@ int draw_text_center(const std::string& str,
 
     const int w_tot_pixel = len * cell_dims.x;
 
+    touch_px_area(px_pos, P(w_tot_pixel, cell_dims.y));
+
     SDL_Rect sdl_rect =
     {
         (Sint16)px_pos.x,
@@ -1061,12 +1646,7 @@ int draw_text_center(const std::string& str,
         (Uint16)cell_dims.y
     };
 
-    SDL_FillRect(scr_srf_,
-                 &sdl_rect,
-                 SDL_MapRGB(scr_srf_->format,
-                            bg_clr.r,
-                            bg_clr.g,
-                            bg_clr.b));
+    fill_px_rect(sdl_rect, bg_clr);
 
     for (int i = 0; i < len; ++i)
     {
@@ -1161,6 +1741,8 @@ void draw_rectangle_solid(const P& px_pos, const P& px_dims, const Clr& clr)
 {
     if (is_inited())
     {
+        touch_px_area(px_pos, px_dims);
+
         SDL_Rect sdl_rect =
         {
             (Sint16)px_pos.x,
@@ -1169,49 +1751,10 @@ void draw_rectangle_solid(const P& px_pos, const P& px_dims, const Clr& clr)
             (Uint16)px_dims.y
         };
 
-        SDL_FillRect(scr_srf_,
-                     &sdl_rect,
-                     SDL_MapRGB(scr_srf_->format,
-                                clr.r,
-                                clr.g,
-                                clr.b));
+        fill_px_rect(sdl_rect, clr);
     }
 }
 
-void draw_projectiles(std::vector<Projectile*>& projectiles,
-                      const bool draw_map_before)
-{
-    if (draw_map_before)
-    {
-        states::draw();
-    }
-
-    for (Projectile* p : projectiles)
-    {
-        if (!p->is_done_rendering && p->is_seen_by_player)
-        {
-            cover_cell_in_map(p->pos);
-
-            if (config::is_tiles_mode())
-            {
-                if (p->tile != TileId::empty)
-                {
-                    draw_tile(p->tile, Panel::map, p->pos, p->clr);
-                }
-            }
-            else // Text mode
-            {
-                if (p->glyph != -1)
-                {
-                    draw_glyph(p->glyph, Panel::map, p->pos, p->clr);
-                }
-            }
-        }
-    }
-
-    update_screen();
-}
-
 void draw_box(const R& border,
               const Panel panel,
               const Clr& clr,
@@ -546,7 +546,7 @@ void PotionClairv::quaff_impl(Actor& actor)
     {
         for (int y = 0; y < map_h; ++y)
         {
-            Cell& cell = map::cells[x][y];
+            Cell cell = map::cells[x][y];
 
             if (!blocks_los[x][y] || always_show[x][y])
             {
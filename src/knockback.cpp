@@ -127,7 +127,7 @@ void run(Actor& defender,
             new PropParalyzed(PropTurns::specific,
                               nr_turns_paralyze));
 
-        defender.pos = new_pos;
+        defender.set_pos(new_pos);
 
         if (is_cell_bottomless &&
             !defender.has_prop(PropId::flying)  &&
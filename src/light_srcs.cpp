@@ -0,0 +1,324 @@
+#include "light_srcs.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "init.hpp"
+#include "map.hpp"
+#include "map_parsing.hpp"
+#include "map_travel.hpp"
+#include "fov.hpp"
+
+namespace light_srcs
+{
+
+namespace
+{
+
+// The sources of one size with the same origin
+struct Srcs
+{
+    Srcs() :
+        nr          (0),
+        is_dirty    (false),
+        lit_cells   () {}
+
+    // Number of registered sources
+    int nr;
+
+    // Should the lit cells be recalculated on the next update?
+    bool is_dirty;
+
+    // The cells currently lit by the sources
+    std::vector<P> lit_cells;
+};
+
+struct SrcKey
+{
+    SrcKey(const P& origin_, const LgtSize size_) :
+        origin  (origin_),
+        size    (size_) {}
+
+    P origin;
+    LgtSize size;
+};
+
+// Indexed by origin and size (LgtSize::none is not stored)
+const int nr_lgt_sizes_ = (int)LgtSize::fov;
+
+Srcs srcs_[map_w][map_h][nr_lgt_sizes_];
+
+Srcs& srcs_at(const P& origin, const LgtSize size)
+{
+    ASSERT(size != LgtSize::none);
+
+    return srcs_[origin.x][origin.y][(int)size - 1];
+}
+
+// Sources to recalculate on the next update
+std::vector<SrcKey> dirty_;
+
+// Origins of all registered FOV sized sources
+std::vector<P> fov_origins_;
+
+// Moving sources as of the last update, and collected during this update
+std::vector<SrcKey> moving_srcs_;
+std::vector<SrcKey> new_moving_srcs_;
+
+// Number of source origins lighting each cell
+int nr_srcs_lighting_[map_w][map_h];
+
+#ifndef NDEBUG
+bool is_updating_ = false;
+#endif // NDEBUG
+
+void set_dirty(const P& origin, const LgtSize size)
+{
+    Srcs& srcs = srcs_at(origin, size);
+
+    if (!srcs.is_dirty)
+    {
+        srcs.is_dirty = true;
+
+        dirty_.push_back(SrcKey(origin, size));
+    }
+}
+
+void calc_lit_cells(const P& origin,
+                    const LgtSize size,
+                    std::vector<P>& out)
+{
+    out.clear();
+
+    switch (size)
+    {
+    case LgtSize::none:
+        break;
+
+    case LgtSize::small:
+    {
+        for (const P& d : dir_utils::dir_list_w_center)
+        {
+            const P p(origin + d);
+
+            if (map::is_pos_inside_map(p))
+            {
+                out.push_back(p);
+            }
+        }
+    }
+    break;
+
+    case LgtSize::fov:
+    {
+        const R area = fov::get_fov_rect(origin);
+
+        bool hard_blocked[map_w][map_h];
+
+        map_parsers::BlocksLos()
+            .run(hard_blocked,
+                 MapParseMode::overwrite,
+                 area);
+
+        LosResult fov[map_w][map_h];
+
+        fov::run(origin, hard_blocked, fov);
+
+        for (int x = area.p0.x; x <= area.p1.x; ++x)
+        {
+            for (int y = area.p0.y; y <= area.p1.y; ++y)
+            {
+                if (!fov[x][y].is_blocked_hard)
+                {
+                    out.push_back(P(x, y));
+                }
+            }
+        }
+    }
+    break;
+    }
+}
+
+// Adds or removes light in the given cells (delta is 1 or -1)
+void apply(const std::vector<P>& lit_cells, const int delta)
+{
+    for (const P& p : lit_cells)
+    {
+        int& nr = nr_srcs_lighting_[p.x][p.y];
+
+        nr += delta;
+
+        ASSERT(nr >= 0);
+
+        map::cells[p.x][p.y].is_lit = nr > 0;
+    }
+}
+
+void update_dirty()
+{
+    // Do not add light on Leng
+    const bool is_lgt_allowed = map_travel::map_type() != MapType::leng;
+
+    for (const SrcKey& key : dirty_)
+    {
+        Srcs& srcs = srcs_at(key.origin, key.size);
+
+        srcs.is_dirty = false;
+
+        apply(srcs.lit_cells, -1);
+
+        srcs.lit_cells.clear();
+
+        if ((srcs.nr > 0) && is_lgt_allowed)
+        {
+            calc_lit_cells(key.origin, key.size, srcs.lit_cells);
+
+            apply(srcs.lit_cells, 1);
+        }
+    }
+
+    dirty_.clear();
+}
+
+} // namespace
+
+void reset()
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            for (int i = 0; i < nr_lgt_sizes_; ++i)
+            {
+                srcs_[x][y][i] = Srcs();
+            }
+
+            nr_srcs_lighting_[x][y] = 0;
+        }
+    }
+
+    dirty_.clear();
+    fov_origins_.clear();
+    moving_srcs_.clear();
+    new_moving_srcs_.clear();
+
+#ifndef NDEBUG
+    is_updating_ = false;
+#endif // NDEBUG
+}
+
+void add(const P& origin, const LgtSize size)
+{
+    if (size == LgtSize::none)
+    {
+        return;
+    }
+
+    Srcs& srcs = srcs_at(origin, size);
+
+    ++srcs.nr;
+
+    if (srcs.nr == 1)
+    {
+        set_dirty(origin, size);
+
+        if (size == LgtSize::fov)
+        {
+            fov_origins_.push_back(origin);
+        }
+    }
+}
+
+void remove(const P& origin, const LgtSize size)
+{
+    if (size == LgtSize::none)
+    {
+        return;
+    }
+
+    Srcs& srcs = srcs_at(origin, size);
+
+    ASSERT(srcs.nr > 0);
+
+    --srcs.nr;
+
+    if (srcs.nr == 0)
+    {
+        set_dirty(origin, size);
+
+        if (size == LgtSize::fov)
+        {
+            auto it = std::find(begin(fov_origins_), end(fov_origins_), origin);
+
+            ASSERT(it != end(fov_origins_));
+
+            fov_origins_.erase(it);
+        }
+    }
+}
+
+void on_los_blocking_changed(const P& p)
+{
+    // NOTE: Sources which have just been removed are already set as dirty, so
+    //       only the registered sources need to be checked
+    for (const P& origin : fov_origins_)
+    {
+        if (fov::is_in_fov_range(origin, p))
+        {
+            set_dirty(origin, LgtSize::fov);
+        }
+    }
+}
+
+void begin_update()
+{
+#ifndef NDEBUG
+    ASSERT(!is_updating_);
+
+    is_updating_ = true;
+#endif // NDEBUG
+
+    new_moving_srcs_.clear();
+}
+
+void add_moving(const P& origin, const LgtSize size)
+{
+#ifndef NDEBUG
+    ASSERT(is_updating_);
+#endif // NDEBUG
+
+    if (size != LgtSize::none)
+    {
+        new_moving_srcs_.push_back(SrcKey(origin, size));
+    }
+}
+
+void end_update()
+{
+#ifndef NDEBUG
+    ASSERT(is_updating_);
+
+    is_updating_ = false;
+#endif // NDEBUG
+
+    // NOTE: The new sources are added before the old ones are removed, so a
+    //       source which has not moved never drops to zero, and keeps its lit
+    //       cells without being recalculated
+    for (const SrcKey& key : new_moving_srcs_)
+    {
+        add(key.origin, key.size);
+    }
+
+    for (const SrcKey& key : moving_srcs_)
+    {
+        remove(key.origin, key.size);
+    }
+
+    std::swap(moving_srcs_, new_moving_srcs_);
+
+    new_moving_srcs_.clear();
+
+    update_dirty();
+}
+
+} // light_srcs
@@ -1,6 +1,9 @@
 #include "line_calc.hpp"
 
 #include <math.h>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
 #include <vector>
 
 #include "global.hpp"
@@ -15,10 +18,258 @@ namespace
 double          fov_abs_distances_[fov_max_w_int][fov_max_w_int];
 std::vector<P>  fov_delta_lines_[fov_max_w_int][fov_max_w_int];
 
+//
+// Lines are traced by taking small steps from the center of the origin cell
+// towards the center of the target cell, and collecting the cells stepped in.
+// Step "k" is at a distance of "k * step_size" from the origin center, so on
+// each axis the cell offset after step k is:
+//
+//   floor(0.5 + (k * step_size * d / hypot))
+//
+// ...where "d" is the delta on that axis, and "hypot" is the length of the
+// whole delta. Instead of walking all steps, the exact step on which each
+// axis enters its next cell is found with integer arithmetic, so only the
+// cells of the line are visited.
+//
+// NOTE: The offset is never exactly on a cell border (this would require
+//       "hypot" to be rational with a matching denominator, which is not
+//       possible for integer deltas), so no rounding rules are needed.
+//
+const int step_size_denom_ = 25; // A step is 1/25 = 0.04 cells
+
+// Deltas longer than this are not supported (for the integer math to fit)
+const int max_delta_ = 1000;
+
+// The number of steps taken (at most) along a line
+int nr_steps()
+{
+    // NOTE: This is the number of iterations of the floating point loop which
+    //       originally traced the lines, including its accumulated rounding
+    static const int nr = []()
+    {
+        int n = 0;
+
+        for (double i = 0.0; i <= 9999.0; i += 1.0 / step_size_denom_)
+        {
+            ++n;
+        }
+
+        return n;
+    }();
+
+    return nr;
+}
+
+// Tracks the cell offset along one axis of a line
+class LineAxis
+{
+public:
+    LineAxis(const int d, const int64_t hypot2) :
+        d_      (d),
+        hypot2_ (hypot2),
+        offset_ (0),
+        nxt_k_  (INT_MAX)
+    {
+        find_nxt_k();
+    }
+
+    int offset() const
+    {
+        return offset_;
+    }
+
+    // The first step on which the next cell along this axis is entered
+    int nxt_k() const
+    {
+        return nxt_k_;
+    }
+
+    void step()
+    {
+        offset_ += (d_ > 0) ? 1 : -1;
+
+        find_nxt_k();
+    }
+
+private:
+    // Has the offset reached the next cell border at step k?
+    //
+    // Moving in positive direction, the offset "c" becomes c + 1 when:
+    //
+    //   c + 1 <= 0.5 + (k * d / (25 * hypot))
+    //   <=> (2 * k * d)^2 >= (25 * (2 * c + 1))^2 * hypot^2
+    //
+    // ...and similarly for the negative direction.
+    bool is_border_passed(const int k) const
+    {
+        const int64_t lhs = int64_t(2) * k * std::abs(d_);
+
+        const int64_t border_nr =
+            (d_ > 0) ?
+            ((2 * int64_t(offset_)) + 1) :
+            (1 - (2 * int64_t(offset_)));
+
+        const int64_t rhs = step_size_denom_ * border_nr;
+
+        return (lhs * lhs) >= (rhs * rhs * hypot2_);
+    }
+
+    void find_nxt_k()
+    {
+        if (d_ == 0)
+        {
+            nxt_k_ = INT_MAX;
+
+            return;
+        }
+
+        // Estimate the step with floating point math, then correct it
+        const double border = 0.5 + std::abs(offset_);
+
+        const double k_db =
+            (border * step_size_denom_ * sqrt(double(hypot2_))) /
+            std::abs(d_);
+
+        if (k_db >= double(nr_steps()) + 1.0)
+        {
+            nxt_k_ = INT_MAX;
+
+            return;
+        }
+
+        int k = std::max(1, int(k_db));
+
+        while (!is_border_passed(k))
+        {
+            ++k;
+        }
+
+        while ((k > 1) && is_border_passed(k - 1))
+        {
+            --k;
+        }
+
+        nxt_k_ = k;
+    }
+
+    const int d_;
+    const int64_t hypot2_;
+    int offset_;
+    int nxt_k_;
+};
+
+// Appends the offsets from the origin of the cells of the line towards the
+// given delta, until "is_done" returns true for an offset, or the line ends
+template<typename IsDone>
+void trace_line(const P& delta, std::vector<P>& out, IsDone is_done)
+{
+    ASSERT(delta != P(0, 0));
+
+    ASSERT(std::abs(delta.x) <= max_delta_ &&
+           std::abs(delta.y) <= max_delta_);
+
+    const int64_t hypot2 =
+        (int64_t(delta.x) * delta.x) +
+        (int64_t(delta.y) * delta.y);
+
+    LineAxis x_axis(delta.x, hypot2);
+    LineAxis y_axis(delta.y, hypot2);
+
+    // The first step is always within the origin cell
+    out.push_back(P(0, 0));
+
+    if (is_done(out.back()))
+    {
+        return;
+    }
+
+    const int nr_steps_max = nr_steps();
+
+    while (true)
+    {
+        const int k = std::min(x_axis.nxt_k(), y_axis.nxt_k());
+
+        if (k > nr_steps_max)
+        {
+            return;
+        }
+
+        // NOTE: Both axes may enter their next cell on the same step
+        if (x_axis.nxt_k() == k)
+        {
+            x_axis.step();
+        }
+
+        if (y_axis.nxt_k() == k)
+        {
+            y_axis.step();
+        }
+
+        out.push_back(P(x_axis.offset(), y_axis.offset()));
+
+        if (is_done(out.back()))
+        {
+            return;
+        }
+    }
+}
+
+//
+// Lines from the origin for all deltas within the map, long enough to leave
+// the map from any origin inside it. Since the cells of a line only depend on
+// the delta, most lines are just a prefix of one of these.
+//
+const int delta_line_w_ = (map_w * 2) - 1;
+const int delta_line_h_ = (map_h * 2) - 1;
+
+std::vector<P> delta_lines_[delta_line_w_][delta_line_h_];
+
+std::vector<P>& delta_line(const P& delta)
+{
+    return delta_lines_[delta.x + map_w - 1][delta.y + map_h - 1];
+}
+
+bool is_delta_line_stored(const P& delta)
+{
+    return
+        (std::abs(delta.x) < map_w) &&
+        (std::abs(delta.y) < map_h) &&
+        (delta != P(0, 0));
+}
+
+void init_delta_lines()
+{
+    const int max_dist = std::max(map_w, map_h);
+
+    for (int dx = -(map_w - 1); dx < map_w; ++dx)
+    {
+        for (int dy = -(map_h - 1); dy < map_h; ++dy)
+        {
+            const P delta(dx, dy);
+
+            if (delta == P(0, 0))
+            {
+                continue;
+            }
+
+            std::vector<P>& line = delta_line(delta);
+
+            line.clear();
+
+            trace_line(delta, line, [max_dist](const P& offset)
+            {
+                return king_dist(P(0, 0), offset) >= max_dist;
+            });
+        }
+    }
+}
+
 } //namespace
 
 void init()
 {
+    init_delta_lines();
+
     //Calculate FOV absolute distances
     for (int y = 0; y < fov_max_w_int; ++y)
     {
@@ -96,61 +347,62 @@ void calc_new_line(const P& origin,
         return;
     }
 
-    const double delta_x_db = double(tgt.x - origin.x);
-    const double delta_y_db = double(tgt.y - origin.y);
+    // Returns true if the line should end at the given offset from the origin
+    // (the cell is only added if it is allowed by the map limits)
+    bool is_outside_map = false;
 
-    const double hypot_db = sqrt((delta_x_db * delta_x_db) + (delta_y_db * delta_y_db));
+    auto is_done = [&](const P& offset)
+    {
+        const P p(origin + offset);
 
-    const double x_incr_db = (delta_x_db / hypot_db);
-    const double y_incr_db = (delta_y_db / hypot_db);
+        if (!allow_outside_map && !map::is_pos_inside_map(p))
+        {
+            is_outside_map = true;
 
-    double current_x_db = double(origin.x) + 0.5;
-    double current_y_db = double(origin.y) + 0.5;
+            return true;
+        }
 
-    P current_pos = P(int(current_x_db), int(current_y_db));
+        return
+            (should_stop_at_target && (p == tgt)) ||
+            (king_dist(P(0, 0), offset) >= king_dist_limit);
+    };
 
-    const double step_size_db = 0.04;
+    const P delta(tgt - origin);
 
-    for (double i = 0.0; i <= 9999.0; i += step_size_db)
+    if (is_delta_line_stored(delta))
     {
-        current_x_db += x_incr_db * step_size_db;
-        current_y_db += y_incr_db * step_size_db;
-
-        current_pos.set(floor(current_x_db), floor(current_y_db));
-
-        if (!allow_outside_map && !map::is_pos_inside_map(current_pos))
+        for (const P& offset : delta_line(delta))
         {
-            return;
-        }
+            if (is_done(offset))
+            {
+                if (!is_outside_map)
+                {
+                    line_ref.push_back(origin + offset);
+                }
 
-        bool is_pos_ok_to_add = false;
+                return;
+            }
 
-        if (line_ref.empty())
-        {
-            is_pos_ok_to_add = true;
-        }
-        else
-        {
-            is_pos_ok_to_add = line_ref.back() != current_pos;
+            line_ref.push_back(origin + offset);
         }
 
-        if (is_pos_ok_to_add)
-        {
-            line_ref.push_back(current_pos);
-        }
+        // The stored line ended without reaching any limit, trace the full
+        // line instead (can only happen when allowing lines outside the map)
+        line_ref.clear();
+    }
 
-        //Check distance limits
-        if (should_stop_at_target && (current_pos == tgt))
-        {
-            return;
-        }
+    std::vector<P> offsets;
 
-        const int current_king_dist = king_dist(origin, current_pos);
+    trace_line(delta, offsets, is_done);
 
-        if (current_king_dist >= king_dist_limit)
-        {
-            return;
-        }
+    if (is_outside_map)
+    {
+        offsets.pop_back();
+    }
+
+    for (const P& offset : offsets)
+    {
+        line_ref.push_back(origin + offset);
     }
 }
 
@@ -409,12 +409,20 @@ void MainMenuState::update()
 
                 init::init_session();
 
-                saving::load_game();
+                if (saving::load_game())
+                {
+                    std::unique_ptr<State> game_state(
+                        new GameState(GameEntryMode::load_game));
 
-                std::unique_ptr<State> game_state(
-                    new GameState(GameEntryMode::load_game));
+                    states::push(std::move(game_state));
+                }
+                else // Failed to load
+                {
+                    init::cleanup_session();
 
-                states::push(std::move(game_state));
+                    popup::show_msg("The save file is corrupt, or from "
+                                    "another version of the game.");
+                }
             }
             else // No save available
             {
@@ -14,27 +14,40 @@
 #include "item.hpp"
 #include "feature_rigid.hpp"
 #include "saving.hpp"
+#include "light_srcs.hpp"
 
 #ifdef DEMO_MODE
 #include "sdl_base.hpp"
 #endif // DEMO_MODE
 
-Cell::Cell() :
-    is_explored         (false),
-    is_seen_by_player   (false),
-    is_lit              (false),
-    is_dark             (false),
-    player_los          (),
-    item                (nullptr),
-    rigid               (nullptr),
-    player_visual_memory(CellRenderData()),
-    pos(P(-1, -1)) {}
-
-Cell::~Cell()
+CellPlanes::CellPlanes()
 {
-    delete rigid;
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            is_explored[x][y] = false;
+            is_seen_by_player[x][y] = false;
+            is_lit[x][y] = false;
+            is_dark[x][y] = false;
+            player_los[x][y] = LosResult();
+            item[x][y] = nullptr;
+            rigid[x][y] = nullptr;
+        }
+    }
+}
 
-    delete item;
+CellPlanes::~CellPlanes()
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            delete rigid[x][y];
+
+            delete item[x][y];
+        }
+    }
 }
 
 void Cell::reset()
@@ -46,8 +59,6 @@ void Cell::reset()
 
     player_visual_memory = CellRenderData();
 
-    pos.set(-1, -1);
-
     delete rigid;
     rigid = nullptr;
 
@@ -64,7 +75,11 @@ int dlvl = 0;
 
 Clr wall_clr;
 
-Cell cells[map_w][map_h];
+CellPlanes cell_planes;
+
+const CellGrid cells = CellGrid();
+
+uint8_t terrain_flags[map_w][map_h];
 
 std::vector<Room*> room_list;
 
@@ -75,14 +90,61 @@ std::vector<ChokePointData> choke_point_data;
 namespace
 {
 
+int terrain_revision_ = 0;
+
+void update_terrain_flags(const P& p)
+{
+    const Rigid* const r = cells[p.x][p.y].rigid;
+
+    uint8_t f = 0;
+
+    if (!r->is_los_passable())
+    {
+        f |= feature_flag::blocks_los;
+    }
+
+    if (!r->can_move_common())
+    {
+        f |= feature_flag::blocks_move_common;
+    }
+
+    if (!r->is_projectile_passable())
+    {
+        f |= feature_flag::blocks_projectiles;
+    }
+
+    if (!r->can_have_item())
+    {
+        f |= feature_flag::blocks_items;
+    }
+
+    if (!r->can_have_rigid())
+    {
+        f |= feature_flag::blocks_rigid;
+    }
+
+    if (!r->is_sound_passable())
+    {
+        f |= feature_flag::blocks_sound;
+    }
+
+    terrain_flags[p.x][p.y] = f;
+}
+
 void reset_cells(const bool make_stone_walls)
 {
+    ++terrain_revision_;
+
+    // NOTE: The light map is cleared below
+    light_srcs::reset();
+
     for (int x = 0; x < map_w; ++x)
     {
         for (int y = 0; y < map_h; ++y)
         {
             cells[x][y].reset();
-            cells[x][y].pos = P(x, y);
+
+            terrain_flags[x][y] = 0;
 
             room_map[x][y] = nullptr;
 
@@ -119,7 +181,7 @@ void cleanup()
     {
         for (int y = 0; y < map_h; ++y)
         {
-            auto& cell = cells[x][y];
+            auto cell = cells[x][y];
 
             delete cell.rigid;
 
@@ -155,10 +217,11 @@ void reset_map()
 
     choke_point_data.clear();
 
-    reset_cells(true);
-
+    // NOTE: The mobs are erased before the cells are reset, so that any light
+    //       they emit is unregistered before the light map is reset
     game_time::erase_all_mobs();
-    game_time::reset_turn_type_and_actor_counters();
+
+    reset_cells(true);
 
     // Occasionally set wall color to something unusual
     if (rnd::one_in(3))
@@ -186,12 +249,21 @@ Rigid* put(Rigid* const f)
 
     const P p = f->pos();
 
-    Cell& cell = cells[p.x][p.y];
+    Cell cell = cells[p.x][p.y];
+
+    if (cell.rigid)
+    {
+        light_srcs::remove(p, cell.rigid->lgt_size());
 
-    delete cell.rigid;
+        delete cell.rigid;
+    }
 
     cell.rigid = f;
 
+    light_srcs::add(p, f->lgt_size());
+
+    on_terrain_changed(p);
+
 #ifdef DEMO_MODE
     if (f->id() == FeatureId::floor)
     {
@@ -216,6 +288,26 @@ Rigid* put(Rigid* const f)
     return f;
 }
 
+int terrain_revision()
+{
+    return terrain_revision_;
+}
+
+void on_terrain_changed(const P& p)
+{
+    const bool blocked_los_before =
+        terrain_blocks(p, feature_flag::blocks_los);
+
+    update_terrain_flags(p);
+
+    if (terrain_blocks(p, feature_flag::blocks_los) != blocked_los_before)
+    {
+        light_srcs::on_los_blocking_changed(p);
+    }
+
+    ++terrain_revision_;
+}
+
 void update_vision()
 {
     game_time::update_light_map();
@@ -286,10 +378,9 @@ bool is_pos_seen_by_player(const P& p)
 
 Actor* actor_at_pos(const P& pos, ActorState state)
 {
-    for (auto* const actor : game_time::actors)
+    for (auto* const actor : game_time::actors_at_pos(pos))
     {
-        if (actor->pos == pos &&
-            actor->state() == state)
+        if (actor->state() == state)
         {
             return actor;
         }
@@ -300,15 +391,9 @@ Actor* actor_at_pos(const P& pos, ActorState state)
 
 Mob* first_mob_at_pos(const P& pos)
 {
-    for (auto* const mob : game_time::mobs)
-    {
-        if (mob->pos() == pos)
-        {
-            return mob;
-        }
-    }
+    const auto& mobs = game_time::mobs_at_pos(pos);
 
-    return nullptr;
+    return mobs.empty() ? nullptr : mobs.front();
 }
 
 void actor_cells(const std::vector<Actor*>& actors, std::vector<P>& out)
@@ -0,0 +1,231 @@
+#include "map_bitset.hpp"
+
+#include <bitset>
+
+#include "init.hpp"
+
+static_assert(map_h <= 32, "Map columns must fit in 32 bits");
+
+MapBitset::MapBitset()
+{
+    clear();
+}
+
+MapBitset::MapBitset(const bool in[map_w][map_h])
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        uint32_t col = 0;
+
+        for (int y = 0; y < map_h; ++y)
+        {
+            col |= uint32_t(in[x][y]) << y;
+        }
+
+        cols_[x] = col;
+    }
+}
+
+MapBitset::MapBitset(const bool in[map_w][map_h], const R& area)
+{
+    clear();
+
+    const int x0 = std::max(0,          area.p0.x);
+    const int y0 = std::max(0,          area.p0.y);
+    const int x1 = std::min(map_w - 1,  area.p1.x);
+    const int y1 = std::min(map_h - 1,  area.p1.y);
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        uint32_t col = 0;
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            col |= uint32_t(in[x][y]) << y;
+        }
+
+        cols_[x] = col;
+    }
+}
+
+void MapBitset::to_array(bool out[map_w][map_h]) const
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        const uint32_t col = cols_[x];
+
+        for (int y = 0; y < map_h; ++y)
+        {
+            out[x][y] = (col >> y) & 1u;
+        }
+    }
+}
+
+void MapBitset::clear()
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        cols_[x] = 0;
+    }
+}
+
+void MapBitset::clear(const R& area)
+{
+    const int x0 = std::max(0,          area.p0.x);
+    const int y0 = std::max(0,          area.p0.y);
+    const int x1 = std::min(map_w - 1,  area.p1.x);
+    const int y1 = std::min(map_h - 1,  area.p1.y);
+
+    if ((x0 > x1) || (y0 > y1))
+    {
+        return;
+    }
+
+    // Bits y0 to y1 (inclusive)
+    const uint32_t area_mask =
+        (col_mask_ >> (map_h - 1 - y1)) &
+        ~((uint32_t(1) << y0) - 1);
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        cols_[x] &= ~area_mask;
+    }
+}
+
+int MapBitset::count() const
+{
+    int nr = 0;
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        nr += std::bitset<32>(cols_[x]).count();
+    }
+
+    return nr;
+}
+
+bool MapBitset::any() const
+{
+    uint32_t all = 0;
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        all |= cols_[x];
+    }
+
+    return all != 0;
+}
+
+MapBitset& MapBitset::operator|=(const MapBitset& other)
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        cols_[x] |= other.cols_[x];
+    }
+
+    return *this;
+}
+
+MapBitset& MapBitset::operator&=(const MapBitset& other)
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        cols_[x] &= other.cols_[x];
+    }
+
+    return *this;
+}
+
+MapBitset MapBitset::operator|(const MapBitset& other) const
+{
+    MapBitset result(*this);
+
+    result |= other;
+
+    return result;
+}
+
+MapBitset MapBitset::operator&(const MapBitset& other) const
+{
+    MapBitset result(*this);
+
+    result &= other;
+
+    return result;
+}
+
+MapBitset MapBitset::operator~() const
+{
+    MapBitset result;
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        result.cols_[x] = ~cols_[x] & col_mask_;
+    }
+
+    return result;
+}
+
+bool MapBitset::operator==(const MapBitset& other) const
+{
+    uint32_t diff = 0;
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        diff |= cols_[x] ^ other.cols_[x];
+    }
+
+    return diff == 0;
+}
+
+bool MapBitset::operator!=(const MapBitset& other) const
+{
+    return !(*this == other);
+}
+
+MapBitset MapBitset::expanded(const int dist) const
+{
+    MapBitset result(*this);
+
+    if (dist <= 0)
+    {
+        return result;
+    }
+
+    // Vertically, by shifting each column
+    for (int x = 0; x < map_w; ++x)
+    {
+        uint32_t col = cols_[x];
+
+        for (int i = 0; i < dist; ++i)
+        {
+            col |= (col << 1) | (col >> 1);
+        }
+
+        result.cols_[x] = col & col_mask_;
+    }
+
+    // Horizontally, by combining neighbouring columns
+    MapBitset tmp;
+
+    for (int i = 0; i < dist; ++i)
+    {
+        tmp.cols_[0] = result.cols_[0] | result.cols_[1];
+
+        for (int x = 1; x < map_w - 1; ++x)
+        {
+            tmp.cols_[x] =
+                result.cols_[x - 1] |
+                result.cols_[x] |
+                result.cols_[x + 1];
+        }
+
+        tmp.cols_[map_w - 1] =
+            result.cols_[map_w - 2] |
+            result.cols_[map_w - 1];
+
+        std::swap(result.cols_, tmp.cols_);
+    }
+
+    return result;
+}
@@ -13,12 +13,39 @@
 namespace map_parsers
 {
 
+namespace
+{
+
+// Accessors for the supported output layer types
+bool get_val(bool (* const& out)[map_h], const P& p)
+{
+    return out[p.x][p.y];
+}
+
+bool get_val(const MapBitset& out, const P& p)
+{
+    return out.at(p);
+}
+
+void set_val(bool (* const& out)[map_h], const P& p, const bool v)
+{
+    out[p.x][p.y] = v;
+}
+
+void set_val(MapBitset& out, const P& p, const bool v)
+{
+    out.set(p, v);
+}
+
+} // namespace
+
 // -----------------------------------------------------------------------------
 // Base class
 // -----------------------------------------------------------------------------
-void MapParser::run(bool out[map_w][map_h],
-                    const MapParseMode write_rule,
-                    const R& area_to_parse_cells)
+template<typename Out>
+void MapParser::run_impl(Out& out,
+                         const MapParseMode write_rule,
+                         const R& area_to_parse_cells)
 {
     ASSERT(parse_cells_ == ParseCells::yes ||
            parse_mobs_ == ParseMobs::yes ||
@@ -43,7 +70,7 @@ void MapParser::run(bool out[map_w][map_h],
 
                 if (is_match || allow_write_false)
                 {
-                    out[x][y] = is_match;
+                    set_val(out, P(x, y), is_match);
                 }
             }
         }
@@ -59,14 +86,10 @@ void MapParser::run(bool out[map_w][map_h],
             {
                 const bool is_match = parse(*mob);
 
-                if (is_match || allow_write_false)
+                if ((is_match || allow_write_false) &&
+                    !get_val(out, p))
                 {
-                    bool& v = out[p.x][p.y];
-
-                    if (!v)
-                    {
-                        v = is_match;
-                    }
+                    set_val(out, p, is_match);
                 }
             }
         }
@@ -82,20 +105,31 @@ void MapParser::run(bool out[map_w][map_h],
             {
                 const bool is_match = parse(*actor);
 
-                if (is_match || allow_write_false)
+                if ((is_match || allow_write_false) &&
+                    !get_val(out, p))
                 {
-                    bool& v = out[p.x][p.y];
-
-                    if (!v)
-                    {
-                        v = is_match;
-                    }
+                    set_val(out, p, is_match);
                 }
             }
         }
     }
 
-} // run
+} // run_impl
+
+
+void MapParser::run(bool out[map_w][map_h],
+                    const MapParseMode write_rule,
+                    const R& area_to_parse_cells)
+{
+    run_impl(out, write_rule, area_to_parse_cells);
+}
+
+void MapParser::run(MapBitset& out,
+                    const MapParseMode write_rule,
+                    const R& area_to_parse_cells)
+{
+    run_impl(out, write_rule, area_to_parse_cells);
+}
 
 
 bool MapParser::cell(const P& p)
@@ -120,38 +154,28 @@ bool MapParser::cell(const P& p)
 
     if (parse_mobs_ == ParseMobs::yes)
     {
-        for (Mob* mob : game_time::mobs)
+        for (Mob* mob : game_time::mobs_at_pos(p))
         {
-            const P& mob_p = mob->pos();
+            const bool is_match = parse(*mob);
 
-            if (mob_p == p)
+            if (is_match)
             {
-                const bool is_match = parse(*mob);
-
-                if (is_match)
-                {
-                    r = true;
-                    break;
-                }
+                r = true;
+                break;
             }
         }
     }
 
     if (parse_actors_ == ParseActors::yes)
     {
-        for (Actor* actor : game_time::actors)
+        for (Actor* actor : game_time::actors_at_pos(p))
         {
-            const P& actor_p = actor->pos;
+            const bool is_match = parse(*actor);
 
-            if (actor_p == p)
+            if (is_match)
             {
-                const bool is_match = parse(*actor);
-
-                if (is_match)
-                {
-                    r = true;
-                    break;
-                }
+                r = true;
+                break;
             }
         }
     }
@@ -162,37 +186,272 @@ bool MapParser::cell(const P& p)
 
 
 // -----------------------------------------------------------------------------
-// Map parsers
+// Static map parsers
 // -----------------------------------------------------------------------------
-bool BlocksLos::parse(const Cell& c)  const
+namespace
 {
-    return
-        !map::is_pos_inside_map(c.pos, false) ||
-        !c.rigid->is_los_passable();
-}
 
-bool BlocksLos::parse(const Mob& f) const
+// Tests a mob against one of the precomputed blocking flags, only asking the
+// feature object when its passability depends on its state
+template<typename Fn>
+bool feature_blocks(const Feature& feature,
+                    const uint8_t flag,
+                    const Fn& is_blocked)
 {
-    return !f.is_los_passable();
+    const uint8_t flags = feature_data::flags(feature.id());
+
+    if (flags & feature_flag::dynamic)
+    {
+        return is_blocked(feature);
+    }
+
+    return flags & flag;
 }
 
-bool BlocksMoveCommon::parse(const Cell& c) const
+bool is_map_edge(const int x, const int y)
 {
     return
-        !map::is_pos_inside_map(c.pos, false) ||
-        !c.rigid->can_move_common();
+        x == 0 ||
+        y == 0 ||
+        x == map_w - 1 ||
+        y == map_h - 1;
 }
 
-bool BlocksMoveCommon::parse(const Mob& f) const
+} // namespace
+
+// NOTE: The predicates below must match the corresponding virtual functions in
+//       the Feature class hierarchy (these are only shortcuts). The rigids are
+//       tested through the per-cell terrain flags kept by the map.
+struct BlocksLosPred
+{
+    static const uint8_t flag = feature_flag::blocks_los;
+    static const bool parse_mobs = true;
+    static const bool parse_actors = false;
+
+    static bool parse(const Mob& f)
+    {
+        return feature_blocks(
+            f,
+            flag,
+            [](const Feature& d) {return !d.is_los_passable();});
+    }
+
+    static bool parse(const Actor& a)
+    {
+        (void)a;
+
+        return false;
+    }
+};
+
+struct BlocksMoveCommonPred
+{
+    static const uint8_t flag = feature_flag::blocks_move_common;
+    static const bool parse_mobs = true;
+    static const bool parse_actors = true;
+
+    static bool parse(const Mob& f)
+    {
+        return feature_blocks(
+            f,
+            flag,
+            [](const Feature& d) {return !d.can_move_common();});
+    }
+
+    static bool parse(const Actor& a)
+    {
+        return a.is_alive();
+    }
+};
+
+struct BlocksProjectilesPred
+{
+    static const uint8_t flag = feature_flag::blocks_projectiles;
+    static const bool parse_mobs = true;
+    static const bool parse_actors = false;
+
+    static bool parse(const Mob& f)
+    {
+        return feature_blocks(
+            f,
+            flag,
+            [](const Feature& d) {return !d.is_projectile_passable();});
+    }
+
+    static bool parse(const Actor& a)
+    {
+        (void)a;
+
+        return false;
+    }
+};
+
+struct BlocksItemsPred
+{
+    static const uint8_t flag = feature_flag::blocks_items;
+    static const bool parse_mobs = true;
+    static const bool parse_actors = false;
+
+    static bool parse(const Mob& f)
+    {
+        return feature_blocks(
+            f,
+            flag,
+            [](const Feature& d) {return !d.can_have_item();});
+    }
+
+    static bool parse(const Actor& a)
+    {
+        (void)a;
+
+        return false;
+    }
+};
+
+struct BlocksRigidPred
+{
+    static const uint8_t flag = feature_flag::blocks_rigid;
+    static const bool parse_mobs = false;
+    static const bool parse_actors = false;
+
+    static bool parse(const Mob& f)
+    {
+        return feature_blocks(
+            f,
+            flag,
+            [](const Feature& d) {return !d.can_have_rigid();});
+    }
+
+    static bool parse(const Actor& a)
+    {
+        (void)a;
+
+        return false;
+    }
+};
+
+template<typename Pred>
+template<typename Out>
+void StaticMapParser<Pred>::run_impl(Out& out,
+                                     const MapParseMode write_rule,
+                                     const R& area_to_parse_cells)
+{
+    const bool allow_write_false =
+        write_rule == MapParseMode::overwrite;
+
+    for (int x = area_to_parse_cells.p0.x;
+         x <= area_to_parse_cells.p1.x;
+         ++x)
+    {
+        for (int y = area_to_parse_cells.p0.y;
+             y <= area_to_parse_cells.p1.y;
+             ++y)
+        {
+            const bool is_match =
+                is_map_edge(x, y) ||
+                (map::terrain_flags[x][y] & Pred::flag);
+
+            if (is_match || allow_write_false)
+            {
+                set_val(out, P(x, y), is_match);
+            }
+        }
+    }
+
+    // NOTE: Mobs and actors can only add blocked cells here, since the cells
+    //       pass above has already written every position in the area
+    if (Pred::parse_mobs)
+    {
+        for (Mob* mob : game_time::mobs)
+        {
+            const P& p = mob->pos();
+
+            if (is_pos_inside(p, area_to_parse_cells) &&
+                Pred::parse(*mob))
+            {
+                set_val(out, p, true);
+            }
+        }
+    }
+
+    if (Pred::parse_actors &&
+        parse_actors_ == ParseActors::yes)
+    {
+        for (Actor* actor : game_time::actors)
+        {
+            const P& p = actor->pos;
+
+            if (is_pos_inside(p, area_to_parse_cells) &&
+                Pred::parse(*actor))
+            {
+                set_val(out, p, true);
+            }
+        }
+    }
+
+} // run_impl
+
+template<typename Pred>
+void StaticMapParser<Pred>::run(bool out[map_w][map_h],
+                                const MapParseMode write_rule,
+                                const R& area_to_parse_cells)
 {
-    return !f.can_move_common();
+    run_impl(out, write_rule, area_to_parse_cells);
 }
 
-bool BlocksMoveCommon::parse(const Actor& a) const
+template<typename Pred>
+void StaticMapParser<Pred>::run(MapBitset& out,
+                                const MapParseMode write_rule,
+                                const R& area_to_parse_cells)
 {
-    return a.is_alive();
+    run_impl(out, write_rule, area_to_parse_cells);
 }
 
+template<typename Pred>
+bool StaticMapParser<Pred>::cell(const P& p)
+{
+    if (is_map_edge(p.x, p.y) ||
+        map::terrain_blocks(p, Pred::flag))
+    {
+        return true;
+    }
+
+    if (Pred::parse_mobs)
+    {
+        for (Mob* mob : game_time::mobs_at_pos(p))
+        {
+            if (Pred::parse(*mob))
+            {
+                return true;
+            }
+        }
+    }
+
+    if (Pred::parse_actors &&
+        parse_actors_ == ParseActors::yes)
+    {
+        for (Actor* actor : game_time::actors_at_pos(p))
+        {
+            if (Pred::parse(*actor))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+
+} // cell
+
+template class StaticMapParser<BlocksLosPred>;
+template class StaticMapParser<BlocksMoveCommonPred>;
+template class StaticMapParser<BlocksProjectilesPred>;
+template class StaticMapParser<BlocksItemsPred>;
+template class StaticMapParser<BlocksRigidPred>;
+
+// -----------------------------------------------------------------------------
+// Map parsers
+// -----------------------------------------------------------------------------
 bool BlocksActor::parse(const Cell& c) const
 {
     return
@@ -210,18 +469,6 @@ bool BlocksActor::parse(const Actor& a) const
     return a.is_alive();
 }
 
-bool BlocksProjectiles::parse(const Cell& c)  const
-{
-    return
-        !map::is_pos_inside_map(c.pos, false) ||
-        !c.rigid->is_projectile_passable();
-}
-
-bool BlocksProjectiles::parse(const Mob& f)  const
-{
-    return !f.is_projectile_passable();
-}
-
 bool LivingActorsAdjToPos::parse(const Actor& a) const
 {
     if (!a.is_alive())
@@ -232,25 +479,6 @@ bool LivingActorsAdjToPos::parse(const Actor& a) const
     return is_pos_adj(pos_, a.pos, true);
 }
 
-bool BlocksItems::parse(const Cell& c)  const
-{
-    return
-        !map::is_pos_inside_map(c.pos, false) ||
-        !c.rigid->can_have_item();
-}
-
-bool BlocksItems::parse(const Mob& f) const
-{
-    return !f.can_have_item();
-}
-
-bool BlocksRigid::parse(const Cell& c)  const
-{
-    return
-        !map::is_pos_inside_map(c.pos, false) ||
-        !c.rigid->can_have_rigid();
-}
-
 bool IsFeature::parse(const Cell& c) const
 {
     return c.rigid->id() == feature_;
@@ -397,48 +625,27 @@ void cells_within_dist_of_others(const bool in[map_w][map_h],
 {
     ASSERT(in != out);
 
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            out[x][y] = false;
-        }
-    }
+    MapBitset out_bits;
+
+    cells_within_dist_of_others(MapBitset(in), out_bits, dist_interval);
+
+    out_bits.to_array(out);
+}
+
+void cells_within_dist_of_others(const MapBitset& in,
+                                 MapBitset& out,
+                                 const Range& dist_interval)
+{
+    ASSERT(&in != &out);
+    ASSERT(dist_interval.min >= 0);
+    ASSERT(dist_interval.max >= dist_interval.min);
 
-    for (int y_outer = 0; y_outer < map_h; y_outer++)
+    out = in.expanded(dist_interval.max);
+
+    // Remove the cells which are closer than the minimum distance
+    if (dist_interval.min > 0)
     {
-        for (int x_outer = 0; x_outer < map_w; x_outer++)
-        {
-            if (!out[x_outer][y_outer])
-            {
-                for (int d = dist_interval.min; d <= dist_interval.max; d++)
-                {
-                    P p0(std::max(0, x_outer - d),
-                         std::max(0, y_outer - d));
-
-                    P p1(std::min(map_w - 1, x_outer + d),
-                         std::min(map_h - 1, y_outer + d));
-
-                    for (int x = p0.x; x <= p1.x; ++x)
-                    {
-                        if (in[x][p0.y] || in[x][p1.y])
-                        {
-                            out[x_outer][y_outer] = true;
-                            break;
-                        }
-                    }
-
-                    for (int y = p0.y; y <= p1.y; ++y)
-                    {
-                        if (in[p0.x][y] || in[p1.x][y])
-                        {
-                            out[x_outer][y_outer] = true;
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+        out &= ~in.expanded(dist_interval.min - 1);
     }
 
 } // cells_within_dist_of_others
@@ -446,12 +653,13 @@ void cells_within_dist_of_others(const bool in[map_w][map_h],
 
 void append(bool base[map_w][map_h], const bool append[map_w][map_h])
 {
-    for (int x = 0; x < map_w; ++x)
+    bool* const base_flat = &base[0][0];
+
+    const bool* const append_flat = &append[0][0];
+
+    for (int i = 0; i < map_w * map_h; ++i)
     {
-        for (int y = 0; y < map_h; ++y)
-        {
-            if (append[x][y]) {base[x][y] = true;}
-        }
+        base_flat[i] = base_flat[i] || append_flat[i];
     }
 }
 
@@ -464,42 +672,18 @@ void expand(const bool in[map_w][map_h],
     const int x1 = std::min(map_w - 1,  area_allowed_to_modify.p1.x);
     const int y1 = std::min(map_h - 1,  area_allowed_to_modify.p1.y);
 
+    // NOTE: Only the cells which can affect the area are read
+    const R area_read(x0 - 1, y0 - 1, x1 + 1, y1 + 1);
+
+    const MapBitset expanded = MapBitset(in, area_read).expanded(1);
+
     for (int x = x0; x <= x1; ++x)
     {
         for (int y = y0; y <= y1; ++y)
         {
-            out[x][y] = false;
-
-            // Search all cells adjacent to the current position for any cell
-            // which is "true" in the input arry.
-            const int cmp_x0 = std::max(x - 1, 0);
-            const int cmp_y0 = std::max(y - 1, 0);
-            const int cmp_x1 = std::min(x + 1, map_w - 1);
-            const int cmp_y1 = std::min(y + 1, map_h - 1);
-
-            for (int cmp_x = cmp_x0; cmp_x <= cmp_x1; ++cmp_x)
-            {
-                bool is_found = false;
-
-                for (int cmp_y = cmp_y0; cmp_y <= cmp_y1; ++cmp_y)
-                {
-                    if (in[cmp_x][cmp_y])
-                    {
-                        out[x][y] = true;
-
-                        is_found = true;
-
-                        break;
-                    }
-                } // Compare y loop
-
-                if (is_found)
-                {
-                    break;
-                }
-            } // Compare x loop
-        } // y loop
-    } // x loop
+            out[x][y] = expanded.at(P(x, y));
+        }
+    }
 
 } // expand
 
@@ -508,44 +692,8 @@ void expand(const bool in[map_w][map_h],
             bool out[map_w][map_h],
             const int dist)
 {
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            out[x][y] = false;
-
-            const int X0 = x - dist;
-            const int Y0 = y - dist;
-            const int X1 = x + dist;
-            const int Y1 = y + dist;
-
-            const int CMP_X0 = X0 < 0 ? 0 : X0;
-            const int CMP_Y0 = Y0 < 0 ? 0 : Y0;
-            const int CMP_X1 = X1 > map_w - 1 ? map_w - 1 : X1;
-            const int CMP_Y1 = Y1 > map_h - 1 ? map_h - 1 : Y1;
-
-            for (int cmp_y = CMP_Y0; cmp_y <= CMP_Y1; ++cmp_y)
-            {
-                bool is_found = false;
-
-                for (int cmp_x = CMP_X0; cmp_x <= CMP_X1; ++cmp_x)
-                {
-                    if (in[cmp_x][cmp_y])
-                    {
-                        is_found = out[x][y] = true;
-                        break;
-                    }
-                }
-
-                if (is_found)
-                {
-                    break;
-                }
-            }
-        }
-    }
-
-} // expand
+    MapBitset(in).expanded(dist).to_array(out);
+}
 
 
 bool is_map_connected(const bool blocked[map_w][map_h])
@@ -3,6 +3,9 @@
 #include "init.hpp"
 
 #include <list>
+#include <climits>
+#include <cstdlib>
+#include <vector>
 
 #ifndef NDEBUG
 #include <chrono>
@@ -15,6 +18,8 @@
 #include "msg_log.hpp"
 #include "feature_rigid.hpp"
 #include "saving.hpp"
+#include "actor_data.hpp"
+#include "item_data.hpp"
 
 namespace map_travel
 {
@@ -24,27 +29,95 @@ std::vector<MapData> map_list;
 namespace
 {
 
+unsigned long attempt_seed(const unsigned long lvl_seed, const int attempt_nr)
+{
+    // Spread the attempt numbers over the seed range (golden ratio hashing)
+    return (lvl_seed + (unsigned long)attempt_nr * 2654435761ul) & 0xFFFFFFFFul;
+}
+
+void seed_rnd(const unsigned long seed)
+{
+    rnd::seed(seed);
+
+    // NOTE: The standard library shuffling uses the C random generator
+    srand((unsigned int)seed);
+}
+
+// The spawn limits used up by populating a level - these are restored before
+// each new attempt, so that a failed attempt does not affect the next one
+struct SpawnState
+{
+    std::vector<int>    actor_nr_left_allowed_to_spawn;
+    std::vector<bool>   item_allow_spawn;
+};
+
+SpawnState get_spawn_state()
+{
+    SpawnState state;
+
+    for (int i = 0; i < (int)ActorId::END; ++i)
+    {
+        state.actor_nr_left_allowed_to_spawn.push_back(
+            actor_data::data[i].nr_left_allowed_to_spawn);
+    }
+
+    for (int i = 0; i < (int)ItemId::END; ++i)
+    {
+        state.item_allow_spawn.push_back(item_data::data[i].allow_spawn);
+    }
+
+    return state;
+}
+
+void set_spawn_state(const SpawnState& state)
+{
+    for (int i = 0; i < (int)ActorId::END; ++i)
+    {
+        actor_data::data[i].nr_left_allowed_to_spawn =
+            state.actor_nr_left_allowed_to_spawn[i];
+    }
+
+    for (int i = 0; i < (int)ItemId::END; ++i)
+    {
+        item_data::data[i].allow_spawn = state.item_allow_spawn[i];
+    }
+}
+
 void mk_lvl(const MapType& map_type)
 {
     TRACE_FUNC_BEGIN;
 
     bool map_ok = false;
 
-#ifndef NDEBUG
     int nr_attempts = 0;
+
+#ifndef NDEBUG
     auto start_time = std::chrono::steady_clock::now();
 #endif
 
-    // TODO: When the map is invalid, any unique items spawned are lost forever.
-    //       Currently, the only effect of this should be that slightly fewever
-    //       unique items are found by the player. It is bad design however, and
-    //       should be fixed.
+    // NOTE: Each attempt uses its own random stream, derived from a seed for
+    //       the level and the attempt number. This way the result of an
+    //       attempt does not depend on how many attempts failed before it, and
+    //       the game continues on a stream which is also independent of this.
+    const unsigned long lvl_seed = rnd::range(0, INT_MAX - 1);
+
+    const unsigned long seed_after_lvl = rnd::range(0, INT_MAX - 1);
+
+    // NOTE: Monsters and items placed by a failed attempt are removed when the
+    //       next attempt resets the map, but the spawn limits they used up must
+    //       also be given back (otherwise e.g. unique items would be lost)
+    const SpawnState spawn_state_before = get_spawn_state();
 
     while (!map_ok)
     {
-#ifndef NDEBUG
+        if (nr_attempts > 0)
+        {
+            set_spawn_state(spawn_state_before);
+        }
+
+        seed_rnd(attempt_seed(lvl_seed, nr_attempts));
+
         ++nr_attempts;
-#endif
 
         switch (map_type)
         {
@@ -78,6 +151,8 @@ void mk_lvl(const MapType& map_type)
         }
     }
 
+    seed_rnd(seed_after_lvl);
+
 #ifndef NDEBUG
     auto diff_time = std::chrono::steady_clock::now() - start_time;
 
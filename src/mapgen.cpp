@@ -37,12 +37,187 @@ bool door_proposals[map_w][map_h];
 namespace
 {
 
+// Tracks which free cells can reach each other (disjoint sets over the cells,
+// 8-connected, with doors counted as free), so that the connectivity of the
+// map can be checked without flood filling it. While connecting rooms, cells
+// only go from blocked to free, so sets are only ever merged.
+class CellConnectivity
+{
+public:
+    void init();
+
+    // Updates the given cells (e.g. the cells carved for a corridor)
+    void update(const std::vector<P>& cells);
+
+    bool is_all_connected() const
+    {
+        return nr_sets_ <= 1;
+    }
+
+    // The set containing the free cells of the room, or -1 if the room has no
+    // free cells
+    int room_set(const Room& room);
+
+private:
+    bool is_free_now(const P& p) const;
+
+    void add_free(const P& p);
+
+    int find(int idx);
+
+    void unite(const int idx0, const int idx1);
+
+    static int idx(const P& p)
+    {
+        return p.x * map_h + p.y;
+    }
+
+    int parent_[nr_map_cells];
+    int size_[nr_map_cells];
+    bool is_free_[map_w][map_h];
+    int nr_sets_;
+};
+
+bool CellConnectivity::is_free_now(const P& p) const
+{
+    return
+        !map_parsers::BlocksMoveCommon(ParseActors::no).cell(p) ||
+        (map::cells[p.x][p.y].rigid->id() == FeatureId::door);
+}
+
+void CellConnectivity::init()
+{
+    nr_sets_ = 0;
+
+    std::fill_n(*is_free_, nr_map_cells, false);
+
+    for (int x = 1; x < map_w - 1; ++x)
+    {
+        for (int y = 1; y < map_h - 1; ++y)
+        {
+            const P p(x, y);
+
+            if (is_free_now(p))
+            {
+                add_free(p);
+            }
+        }
+    }
+}
+
+void CellConnectivity::update(const std::vector<P>& cells)
+{
+    for (const P& p : cells)
+    {
+        const bool is_free = is_free_now(p);
+
+        if (is_free == is_free_[p.x][p.y])
+        {
+            continue;
+        }
+
+        if (is_free)
+        {
+            add_free(p);
+        }
+        else // A free cell was blocked - sets cannot be split, start over
+        {
+            init();
+
+            return;
+        }
+    }
+}
+
+int CellConnectivity::room_set(const Room& room)
+{
+    const R& r = room.r_;
+
+    for (int x = r.p0.x; x <= r.p1.x; ++x)
+    {
+        for (int y = r.p0.y; y <= r.p1.y; ++y)
+        {
+            if (is_free_[x][y] &&
+                (map::room_map[x][y] == &room))
+            {
+                return find(idx(P(x, y)));
+            }
+        }
+    }
+
+    return -1;
+}
+
+void CellConnectivity::add_free(const P& p)
+{
+    const int p_idx = idx(p);
+
+    is_free_[p.x][p.y] = true;
+
+    parent_[p_idx] = p_idx;
+    size_[p_idx] = 1;
+
+    ++nr_sets_;
+
+    for (const P& d : dir_utils::dir_list)
+    {
+        const P adj_p(p + d);
+
+        if (is_free_[adj_p.x][adj_p.y])
+        {
+            unite(p_idx, idx(adj_p));
+        }
+    }
+}
+
+int CellConnectivity::find(int idx)
+{
+    while (parent_[idx] != idx)
+    {
+        // Path halving
+        parent_[idx] = parent_[parent_[idx]];
+
+        idx = parent_[idx];
+    }
+
+    return idx;
+}
+
+void CellConnectivity::unite(const int idx0, const int idx1)
+{
+    int root0 = find(idx0);
+    int root1 = find(idx1);
+
+    if (root0 == root1)
+    {
+        return;
+    }
+
+    if (size_[root0] < size_[root1])
+    {
+        std::swap(root0, root1);
+    }
+
+    parent_[root1] = root0;
+
+    size_[root0] += size_[root1];
+
+    --nr_sets_;
+}
+
+CellConnectivity connectivity_;
+
 void connect_rooms()
 {
     TRACE_FUNC_BEGIN;
 
     int nr_tries_left = 5000;
 
+    connectivity_.init();
+
+    // The cells made free by each corridor
+    std::vector<P> carved;
+
     while (true)
     {
         // NOTE: Keep this counter at the top of the loop, since otherwise a
@@ -86,17 +261,44 @@ void connect_rooms()
             continue;
         }
 
+        // While the map is not connected, prefer connecting to a room which
+        // cannot be reached from room 0 yet (but do not insist - such rooms
+        // may all have other rooms in the way)
+        int nr_tries_unconnected_room =
+            connectivity_.is_all_connected() ? 0 : 16;
+
+        const int room0_set =
+            (nr_tries_unconnected_room > 0) ?
+            connectivity_.room_set(*room0) :
+            -1;
+
         // Finding second room to connect to
-        Room* room1 = rnd_room();
-
-        // Room 1 must not be the same as room 0, and it must be a connectable
-        // room (connections are only allowed between two standard rooms, or
-        // from a corridor link to a standard room - never between two corridor
-        // links)
-        while ((room1 == room0) ||
-               !is_connectable_room(*room1))
+        Room* room1 = nullptr;
+
+        while (true)
         {
             room1 = rnd_room();
+
+            // Room 1 must not be the same as room 0, and it must be a
+            // connectable room (connections are only allowed between two
+            // standard rooms, or from a corridor link to a standard room -
+            // never between two corridor links)
+            if ((room1 == room0) ||
+                !is_connectable_room(*room1))
+            {
+                continue;
+            }
+
+            if ((room0_set != -1) &&
+                (nr_tries_unconnected_room > 0) &&
+                (connectivity_.room_set(*room1) == room0_set))
+            {
+                --nr_tries_unconnected_room;
+
+                continue;
+            }
+
+            break;
         }
 
         // Do not allow two rooms to be connected twice
@@ -152,32 +354,20 @@ void connect_rooms()
         }
 
         // Alright, let's try to connect these rooms
+        carved.clear();
+
         mk_pathfind_corridor(*room0,
                              *room1,
-                             door_proposals);
-
-        bool blocked[map_w][map_h];
+                             door_proposals,
+                             &carved);
 
-        map_parsers::BlocksMoveCommon(ParseActors::no).
-            run(blocked);
-
-        //
-        // Do not consider doors blocking
-        //
-        for (int x = 0; x < map_w; ++x)
-        {
-            for (int y = 0; y < map_h; ++y)
-            {
-                if (map::cells[x][y].rigid->id() == FeatureId::door)
-                {
-                    blocked[x][y] = false;
-                }
-            }
-        }
+        connectivity_.update(carved);
 
         if ((nr_tries_left <= 2 || rnd::one_in(4)) &&
-            map_parsers::is_map_connected(blocked))
+            connectivity_.is_all_connected())
         {
+            ASSERT(is_all_rooms_connected());
+
             break;
         }
     }
@@ -297,7 +487,7 @@ void move_player_to_nearest_allowed_pos()
              allowed_cells_list.end(),
              is_closer_to_origin);
 
-        map::player->pos = allowed_cells_list.front();
+        map::player->set_pos(allowed_cells_list.front());
 
     }
 
@@ -673,64 +863,48 @@ bool mk_std_lvl()
         }
     }
 
-    for (int x = 0; x < map_w; ++x)
+    std::vector<ChokePointData> choke_points;
+
+    find_choke_points(blocked,
+                      door_proposals,
+                      choke_points);
+
+    for (ChokePointData& d : choke_points)
     {
-        for (int y = 0; y < map_h; ++y)
+        // Find player and stair side
+        for (size_t side_idx = 0; side_idx < 2; ++side_idx)
         {
-            if (!blocked[x][y] && door_proposals[x][y])
+            for (const P& p : d.sides[side_idx])
             {
-                ChokePointData d;
-
-                const bool is_choke =
-                    is_choke_point(P(x, y),
-                                   blocked,
-                                   d);
-
-                // 'is_choke_point' called above may invalidate the map
-                if (!is_map_valid)
+                if (p == map::player->pos)
                 {
-                    return false;
+                    ASSERT(d.player_side == -1);
+
+                    d.player_side = side_idx;
                 }
 
-                if (is_choke)
+                if (p == stairs_pos)
                 {
-                    // Find player and stair side
-                    for (size_t side_idx = 0; side_idx < 2; ++side_idx)
-                    {
-                        for (const P& p : d.sides[side_idx])
-                        {
-                            if (p == map::player->pos)
-                            {
-                                ASSERT(d.player_side == -1);
-
-                                d.player_side = side_idx;
-                            }
-
-                            if (p == stairs_pos)
-                            {
-                                ASSERT(d.stairs_side == -1);
-
-                                d.stairs_side = side_idx;
-                            }
-                        }
-                    }
-
-                    ASSERT(d.player_side == 0 || d.player_side == 1);
-                    ASSERT(d.stairs_side == 0 || d.stairs_side == 1);
-
-                    // Robustness for release mode
-                    if ((d.player_side != 0 && d.player_side != 1) ||
-                        (d.player_side != 0 && d.player_side != 1))
-                    {
-                        // Go to next map position
-                        continue;
-                    }
-
-                    map::choke_point_data.emplace_back(d);
+                    ASSERT(d.stairs_side == -1);
+
+                    d.stairs_side = side_idx;
                 }
             }
-        } // y loop
-    } // x loop
+        }
+
+        ASSERT(d.player_side == 0 || d.player_side == 1);
+        ASSERT(d.stairs_side == 0 || d.stairs_side == 1);
+
+        // Robustness for release mode
+        if ((d.player_side != 0 && d.player_side != 1) ||
+            (d.player_side != 0 && d.player_side != 1))
+        {
+            // Go to next choke point
+            continue;
+        }
+
+        map::choke_point_data.emplace_back(d);
+    }
 
     TRACE << "Found " << map::choke_point_data.size()
           << " choke points" << std::endl;
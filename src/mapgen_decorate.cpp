@@ -17,7 +17,7 @@ void decorate()
     {
         for (int y = 0; y < map_h; ++y)
         {
-            Cell& cell = map::cells[x][y];
+            Cell cell = map::cells[x][y];
 
             if (cell.rigid->id() == FeatureId::wall)
             {
@@ -62,7 +62,7 @@ void decorate()
                             continue;
                         }
 
-                        auto& adj_cell = map::cells[p_adj.x][p_adj.y];
+                        auto adj_cell = map::cells[p_adj.x][p_adj.y];
 
                         const auto adj_id = adj_cell.rigid->id();
 
@@ -65,7 +65,7 @@ void mk_monoliths()
 
         const P p = rnd::element(p_bucket);
 
-        map::cells[p.x][p.y].rigid = new Monolith(p);
+        map::put(new Monolith(p));
 
         for (const P& d : dir_utils::dir_list_w_center)
         {
@@ -117,9 +117,9 @@ void mk_pylons_and_levers()
 
         lever->set_linked_feature(*pylon);
 
-        map::cells[pylon_p.x][pylon_p.y].rigid = pylon;
+        map::put(pylon);
 
-        map::cells[lever_p.x][lever_p.y].rigid = lever;
+        map::put(lever);
 
         //
         // Don't place other pylons too near
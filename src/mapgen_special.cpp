@@ -59,7 +59,7 @@ bool mk_intro_lvl()
 
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
             }
             break;
@@ -328,7 +328,7 @@ bool mk_egypt_lvl()
             {
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
 
                 if (c == stair_c)
@@ -428,7 +428,7 @@ bool mk_leng_lvl()
 
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
                 else if (c == 'S')
                 {
@@ -550,7 +550,7 @@ bool mk_rat_cave_level()
 
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
                 else if (c == '1')
                 {
@@ -668,7 +668,7 @@ bool mk_boss_lvl()
 
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
                 else if (c == 'M')
                 {
@@ -738,7 +738,7 @@ bool mk_trapez_lvl()
 
                 if (c == '@')
                 {
-                    map::player->pos = p;
+                    map::player->set_pos(p);
                 }
                 else if (c == 'o')
                 {
@@ -12,6 +12,7 @@
 #include "feature_rigid.hpp"
 #include "game_time.hpp"
 #include "feature_door.hpp"
+#include "flood_workspace.hpp"
 #include "init.hpp"
 
 namespace mapgen
@@ -19,6 +20,211 @@ namespace mapgen
 
 bool is_map_valid = true;
 
+namespace
+{
+
+// Shared by the flood fills and pathfinding below
+FloodWorkspace flood_;
+
+// Depth first search over the free cells (8-connected), for finding
+// articulation points - i.e. cells which split the map when blocked (Tarjan)
+struct ChokeDfs
+{
+    // Discovery number of each cell (zero if not visited)
+    int disc[map_w][map_h];
+
+    // Lowest discovery number reachable from the subtree of the cell through
+    // at most one back edge
+    int low[map_w][map_h];
+
+    // Highest discovery number in the subtree of the cell - the subtree is
+    // exactly the cells numbered from "disc" to "last"
+    int last[map_w][map_h];
+
+    // Connected component number
+    int cc[map_w][map_h];
+
+    P parent[map_w][map_h];
+
+    std::vector<std::pair<P, size_t>> stack;
+};
+
+ChokeDfs choke_dfs_;
+
+bool is_choke_dfs_cell(const P& p)
+{
+    return map::is_pos_inside_map(p, false);
+}
+
+void run_choke_dfs(const bool blocked[map_w][map_h])
+{
+    ChokeDfs& dfs = choke_dfs_;
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            dfs.disc[x][y] = 0;
+            dfs.low[x][y] = 0;
+            dfs.last[x][y] = 0;
+            dfs.cc[x][y] = 0;
+            dfs.parent[x][y].set(-1, -1);
+        }
+    }
+
+    dfs.stack.clear();
+    dfs.stack.reserve(nr_map_cells);
+
+    const size_t nr_dirs = dir_utils::dir_list.size();
+
+    int nr_visited = 0;
+    int nr_cc = 0;
+
+    for (int x = 1; x < map_w - 1; ++x)
+    {
+        for (int y = 1; y < map_h - 1; ++y)
+        {
+            if (blocked[x][y] || (dfs.disc[x][y] != 0))
+            {
+                continue;
+            }
+
+            ++nr_cc;
+
+            ++nr_visited;
+
+            dfs.disc[x][y] = dfs.low[x][y] = nr_visited;
+            dfs.cc[x][y] = nr_cc;
+
+            dfs.stack.push_back({P(x, y), 0});
+
+            while (!dfs.stack.empty())
+            {
+                const P p = dfs.stack.back().first;
+
+                if (dfs.stack.back().second < nr_dirs)
+                {
+                    const P adj_p(
+                        p + dir_utils::dir_list[dfs.stack.back().second]);
+
+                    ++dfs.stack.back().second;
+
+                    if (!is_choke_dfs_cell(adj_p) ||
+                        blocked[adj_p.x][adj_p.y])
+                    {
+                        continue;
+                    }
+
+                    int& adj_disc = dfs.disc[adj_p.x][adj_p.y];
+
+                    if (adj_disc == 0)
+                    {
+                        ++nr_visited;
+
+                        adj_disc = dfs.low[adj_p.x][adj_p.y] = nr_visited;
+                        dfs.cc[adj_p.x][adj_p.y] = nr_cc;
+                        dfs.parent[adj_p.x][adj_p.y] = p;
+
+                        dfs.stack.push_back({adj_p, 0});
+                    }
+                    else if (adj_p != dfs.parent[p.x][p.y])
+                    {
+                        dfs.low[p.x][p.y] =
+                            std::min(dfs.low[p.x][p.y], adj_disc);
+                    }
+                }
+                else // All neighbours visited
+                {
+                    dfs.last[p.x][p.y] = nr_visited;
+
+                    dfs.stack.pop_back();
+
+                    if (!dfs.stack.empty())
+                    {
+                        const P& parent_p = dfs.stack.back().first;
+
+                        dfs.low[parent_p.x][parent_p.y] =
+                            std::min(dfs.low[parent_p.x][parent_p.y],
+                                     dfs.low[p.x][p.y]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns the discovery number of the child of "p" whose subtree contains
+// "other_p", if that subtree is cut off from the rest of the map when "p" is
+// blocked. Otherwise (i.e. "other_p" is on the same side as the parent of
+// "p"), zero is returned.
+int separated_subtree(const P& p, const P& other_p)
+{
+    const ChokeDfs& dfs = choke_dfs_;
+
+    const int other_disc = dfs.disc[other_p.x][other_p.y];
+
+    for (const P& d : dir_utils::dir_list)
+    {
+        const P child_p(p + d);
+
+        if (!is_choke_dfs_cell(child_p) ||
+            (dfs.parent[child_p.x][child_p.y] != p))
+        {
+            continue;
+        }
+
+        const int child_disc = dfs.disc[child_p.x][child_p.y];
+
+        if ((other_disc >= child_disc) &&
+            (other_disc <= dfs.last[child_p.x][child_p.y]))
+        {
+            return
+                (dfs.low[child_p.x][child_p.y] >= dfs.disc[p.x][p.y]) ?
+                child_disc :
+                0;
+        }
+    }
+
+    return 0;
+}
+
+// Finds the two free cells cardinally adjacent to a potential choke point -
+// returns false if there are not exactly two such cells
+bool find_choke_point_sides(const P& p,
+                            const bool blocked[map_w][map_h],
+                            P& p_side1,
+                            P& p_side2)
+{
+    p_side1.set(0, 0);
+    p_side2.set(0, 0);
+
+    for (const P& d : dir_utils::cardinal_list)
+    {
+        const P adj_p(p + d);
+
+        if (!blocked[adj_p.x][adj_p.y])
+        {
+            if (p_side1.x == 0)
+            {
+                p_side1 = adj_p;
+            }
+            else if (p_side2.x == 0)
+            {
+                p_side2 = adj_p;
+            }
+            else // Both p0 and p1 has already been set
+            {
+                // This is not a choke point, bye!
+                return false;
+            }
+        }
+    }
+
+    return p_side2.x != 0;
+}
+
+} // namespace
+
 bool is_all_rooms_connected()
 {
     bool blocked[map_w][map_h];
@@ -320,46 +526,26 @@ void cavify_room(Room& room)
             continue;
         }
 
-        int flood[map_w][map_h];
-
-        floodfill(origin,
-                  blocked,
-                  flood,
-                  rnd::range(1, 4),
-                  P( -1, -1),
-                  false);
+        flood_.run(origin,
+                   blocked,
+                   rnd::range(1, 4),
+                   false);
 
-        for (int x = 0; x < map_w; ++x)
+        for (const P& p : flood_.reached())
         {
-            for (int y = 0; y < map_h; ++y)
+            if (p == origin)
             {
-                if (flood[x][y] > 0)
-                {
-                    map::put(new Floor({x, y}));
-
-                    map::room_map[x][y] = &room;
-
-                    if (x < room_rect.p0.x)
-                    {
-                        room_rect.p0.x = x;
-                    }
+                continue;
+            }
 
-                    if (y < room_rect.p0.y)
-                    {
-                        room_rect.p0.y = y;
-                    }
+            map::put(new Floor(p));
 
-                    if (x > room_rect.p1.x)
-                    {
-                        room_rect.p1.x = x;
-                    }
+            map::room_map[p.x][p.y] = &room;
 
-                    if (y > room_rect.p1.y)
-                    {
-                        room_rect.p1.y = y;
-                    }
-                }
-            }
+            room_rect.p0.x = std::min(room_rect.p0.x, p.x);
+            room_rect.p0.y = std::min(room_rect.p0.y, p.y);
+            room_rect.p1.x = std::max(room_rect.p1.x, p.x);
+            room_rect.p1.y = std::max(room_rect.p1.y, p.y);
         }
     }
 
@@ -497,26 +683,9 @@ bool is_choke_point(const P& p,
     P p_side1;
     P p_side2;
 
-    for (const P& d : dir_utils::cardinal_list)
+    if (!find_choke_point_sides(p, blocked, p_side1, p_side2))
     {
-        const P adj_p(p + d);
-
-        if (!blocked[adj_p.x][adj_p.y])
-        {
-            if (p_side1.x == 0)
-            {
-                p_side1 = adj_p;
-            }
-            else if (p_side2.x == 0)
-            {
-                p_side2 = adj_p;
-            }
-            else // Both p0 and p1 has already been set
-            {
-                // This is not a choke point, bye!
-                return false;
-            }
-        }
+        return false;
     }
 
     // OK, the position has exactly two free cardinally adjacent cells
@@ -591,9 +760,104 @@ bool is_choke_point(const P& p,
     return true;
 }
 
+void find_choke_points(const bool blocked[map_w][map_h],
+                       const bool candidates[map_w][map_h],
+                       std::vector<ChokePointData>& out)
+{
+    run_choke_dfs(blocked);
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            if (!candidates[x][y] || blocked[x][y])
+            {
+                continue;
+            }
+
+            const P p(x, y);
+
+            P p_side1;
+            P p_side2;
+
+            if (!find_choke_point_sides(p, blocked, p_side1, p_side2))
+            {
+                continue;
+            }
+
+            // The search only covers the cells inside the map edge (like the
+            // flood fills) - use the flood fill method for anything else
+            if (!is_choke_dfs_cell(p) ||
+                !is_choke_dfs_cell(p_side1) ||
+                !is_choke_dfs_cell(p_side2))
+            {
+                ChokePointData d;
+
+                if (is_choke_point(p, blocked, d))
+                {
+                    out.push_back(d);
+                }
+
+                continue;
+            }
+
+            const int side1_subtree = separated_subtree(p, p_side1);
+            const int side2_subtree = separated_subtree(p, p_side2);
+
+            if (side1_subtree == side2_subtree)
+            {
+                // The two sides can still reach each other - not a choke point
+                continue;
+            }
+
+            ChokePointData d;
+
+            d.p = p;
+
+            // Add the positions in the same order as "is_choke_point": the
+            // side origins first, then the other cells column by column
+            d.sides[0].push_back(p_side1);
+            d.sides[1].push_back(p_side2);
+
+            const int cc = choke_dfs_.cc[x][y];
+
+            for (int side_x = 1; side_x < map_w - 1; ++side_x)
+            {
+                for (int side_y = 1; side_y < map_h - 1; ++side_y)
+                {
+                    const P side_p(side_x, side_y);
+
+                    if (blocked[side_x][side_y] ||
+                        (choke_dfs_.cc[side_x][side_y] != cc) ||
+                        (side_p == p) ||
+                        (side_p == p_side1) ||
+                        (side_p == p_side2))
+                    {
+                        continue;
+                    }
+
+                    const int subtree = separated_subtree(p, side_p);
+
+                    if (subtree == side1_subtree)
+                    {
+                        d.sides[0].push_back(side_p);
+                    }
+                    else if (subtree == side2_subtree)
+                    {
+                        d.sides[1].push_back(side_p);
+                    }
+                }
+            }
+
+            out.push_back(d);
+        }
+    }
+}
+
 void mk_pathfind_corridor(Room& room_0,
                           Room& room_1,
-                          bool door_proposals[map_w][map_h])
+                          bool door_proposals[map_w][map_h],
+                          std::vector<P>* const carved_out)
 {
     TRACE_FUNC_BEGIN_VERBOSE << "Making corridor between rooms "
                              << &room_0 << " and " << &room_1
@@ -761,12 +1025,12 @@ void mk_pathfind_corridor(Room& room_0,
         // just randomizes the variation of optimal path)
         const bool randomize_step_choices = true;
 
-        pathfind(p0,
-                 p1,
-                 blocked_expanded,
-                 path,
-                 allow_diagonal,
-                 randomize_step_choices);
+        flood_.pathfind(p0,
+                        p1,
+                        blocked_expanded,
+                        path,
+                        allow_diagonal,
+                        randomize_step_choices);
     }
 
     if (!path.empty())
@@ -840,6 +1104,11 @@ void mk_pathfind_corridor(Room& room_0,
                             !blocked_expanded[p_adj.x][p_adj.y])
                         {
                             map::put(new Floor(p_adj));
+
+                            if (carved_out)
+                            {
+                                carved_out->push_back(p_adj);
+                            }
                         }
                     }
                 }
@@ -847,6 +1116,11 @@ void mk_pathfind_corridor(Room& room_0,
 
             map::put(new Floor(p));
 
+            if (carved_out)
+            {
+                carved_out->push_back(p);
+            }
+
             // Make it possible to branch from the corridor
             if ((i > 1) &&
                 ((int)i < (int)path.size() - 3) &&
@@ -900,7 +1174,7 @@ void pathfinder_walk(const P& p0,
     bool blocked[map_w][map_h] = {};
 
     std::vector<P> path;
-    pathfind(p0, p1, blocked, path);
+    flood_.pathfind(p0, p1, blocked, path);
 
     std::vector<P> rnd_walk_buffer;
 
@@ -79,10 +79,8 @@ void MarkerState::draw()
         {
             const P& p(line[i]);
 
-            const Cell& c = map::cells[p.x][p.y];
-
-            if (c.is_seen_by_player &&
-                !c.rigid->is_projectile_passable())
+            if (map::cells[p.x][p.y].is_seen_by_player &&
+                map::terrain_blocks(p, feature_flag::blocks_projectiles))
             {
                 red_from_idx = i;
                 break;
@@ -236,9 +236,9 @@ void add(const std::string& str,
         lines_[current_line_nr].push_back(Msg(str, clr, x_pos));
     }
 
-    io::clear_screen();
-
-    states::draw();
+    // NOTE: Several messages are often added in a row (e.g. by explosions),
+    //       so the screen is not redrawn for each message here
+    io::request_redraw();
 
     if (add_more_prompt_on_msg == MorePromptOnMsg::yes)
     {
@@ -264,6 +264,9 @@ void more_prompt()
         return;
     }
 
+    // NOTE: This also takes care of any redraw requested by adding messages
+    io::clear_screen();
+
     states::draw();
 
     draw();
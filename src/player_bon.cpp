@@ -186,20 +186,14 @@ void save()
 {
     saving::put_int((int)bg_);
 
-    for (size_t i = 0; i < (size_t)Trait::END; ++i)
-    {
-        saving::put_bool(traits[i]);
-    }
+    saving::put_bool_arr(traits, (size_t)Trait::END);
 }
 
 void load()
 {
     bg_ = Bg(saving::get_int());
 
-    for (size_t i = 0; i < (size_t)Trait::END; ++i)
-    {
-        traits[i] = saving::get_bool();
-    }
+    saving::get_bool_arr(traits, (size_t)Trait::END);
 }
 
 std::string bg_title(const Bg id)
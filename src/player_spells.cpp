@@ -172,10 +172,7 @@ void save()
         saving::put_int((int)s->id());
     }
 
-    for (size_t i = 0; i < (size_t)SpellId::END; ++i)
-    {
-        saving::put_int(spell_skill_pct_[i]);
-    }
+    saving::put_int_arr(spell_skill_pct_, (size_t)SpellId::END);
 }
 
 void load()
@@ -189,10 +186,7 @@ void load()
         learned_spells_.push_back(spell_handling::mk_spell_from_id(id));
     }
 
-    for (size_t i = 0; i < (size_t)SpellId::END; ++i)
-    {
-        spell_skill_pct_[i] = saving::get_int();
-    }
+    saving::get_int_arr(spell_skill_pct_, (size_t)SpellId::END);
 }
 
 bool is_spell_learned(const SpellId id)
@@ -2169,7 +2169,7 @@ void PropBlessed::bless_adjacent() const
     {
         const P p_adj(p + d);
 
-        Cell& cell = map::cells[p_adj.x][p_adj.y];
+        Cell cell = map::cells[p_adj.x][p_adj.y];
 
         Rigid* const rigid = cell.rigid;
 
@@ -2235,7 +2235,7 @@ void PropCursed::curse_adjacent() const
     {
         const P p_adj(p + d);
 
-        Cell& cell = map::cells[p_adj.x][p_adj.y];
+        Cell cell = map::cells[p_adj.x][p_adj.y];
 
         Rigid* const rigid = cell.rigid;
 
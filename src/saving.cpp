@@ -1,7 +1,10 @@
 #include "saving.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "init.hpp"
 #include "msg_log.hpp"
@@ -41,13 +44,126 @@ State state_;
 
 #endif // NDEBUG
 
-std::vector<std::string> lines_;
+// The save file consists of a fixed size header, followed by the data written
+// by the modules. All integers are stored as little endian, regardless of the
+// platform.
+//
+// Header:
+//   4 bytes   magic       "IASV"
+//   4 bytes   version     save_version_
+//   4 bytes   data size   number of bytes following the header
+//   4 bytes   checksum    FNV-1a hash of the data
+//
+// Each value in the data is preceded by a one byte type tag, so that reading
+// a value of the wrong type (i.e. the save and load code is out of sync, or the
+// file is corrupted) is detected immediately.
+
+const char save_magic_[4] = {'I', 'A', 'S', 'V'};
+
+// NOTE: Bump this whenever the saved data changes
+const uint32_t save_version_ = 1;
+
+const size_t header_size_ = 16;
+
+enum class ValType : uint8_t
+{
+    integer,
+    boolean,
+    str,
+    int_arr,
+    bool_arr
+};
+
+const std::string save_path_ = "res/data/save";
+
+// Saving: data put by the modules (excluding the header)
+// Loading: the entire file contents (including the header)
+std::vector<uint8_t> buffer_;
+
+size_t read_pos_ = 0;
+
+// Set when reading data which does not match what the game expects (i.e. the
+// save file is corrupted, or the save and load code is out of sync)
+bool is_corrupt_ = false;
+
+uint32_t checksum(const uint8_t* const data, const size_t size)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void write_u32(const uint32_t v, std::vector<uint8_t>& out)
+{
+    out.push_back(uint8_t(v));
+    out.push_back(uint8_t(v >> 8));
+    out.push_back(uint8_t(v >> 16));
+    out.push_back(uint8_t(v >> 24));
+}
+
+uint32_t read_u32(const uint8_t* const data)
+{
+    return  uint32_t(data[0])         |
+           (uint32_t(data[1]) << 8)   |
+           (uint32_t(data[2]) << 16)  |
+           (uint32_t(data[3]) << 24);
+}
+
+void put_tag(const ValType type)
+{
+#ifndef NDEBUG
+    ASSERT(state_ == State::saving);
+#endif // NDEBUG
+
+    buffer_.push_back(uint8_t(type));
+}
+
+// Returns false if there is not enough data left, or if the next value is not
+// of the expected type (i.e. the save file is corrupted)
+bool get_tag(const ValType type, const size_t nr_bytes_following)
+{
+#ifndef NDEBUG
+    ASSERT(state_ == State::loading);
+#endif // NDEBUG
+
+    const size_t nr_bytes_left = buffer_.size() - read_pos_;
+
+    if (is_corrupt_ ||
+        (nr_bytes_left < (1 + nr_bytes_following)) ||
+        (buffer_[read_pos_] != uint8_t(type)))
+    {
+        TRACE << "Unexpected value in save file" << std::endl;
+
+        is_corrupt_ = true;
+
+        return false;
+    }
+
+    ++read_pos_;
+
+    return true;
+}
+
+uint32_t get_u32()
+{
+    const uint32_t v = read_u32(&buffer_[read_pos_]);
+
+    read_pos_ += 4;
+
+    return v;
+}
 
 void save_modules()
 {
     TRACE_FUNC_BEGIN;
 
-    ASSERT(lines_.empty());
+    ASSERT(buffer_.empty());
 
     put_str(map::player->name_a());
 
@@ -73,11 +189,18 @@ void load_modules()
 {
     TRACE_FUNC_BEGIN;
 
-    ASSERT(!lines_.empty());
+    ASSERT(read_pos_ == header_size_);
 
     const std::string player_name = get_str();
 
-    ASSERT(!player_name.empty());
+    if (player_name.empty())
+    {
+        is_corrupt_ = true;
+
+        TRACE_FUNC_END;
+
+        return;
+    }
 
     map::player->data().name_a      = player_name;
     map::player->data().name_the    = player_name;
@@ -100,54 +223,126 @@ void load_modules()
     TRACE_FUNC_END;
 }
 
+// Writes the header and the buffered data in one go. If the buffer is empty,
+// an empty file is written (i.e. there is no save available).
 void write_file()
 {
-    std::ofstream file;
+    std::vector<uint8_t> header;
+
+    if (!buffer_.empty())
+    {
+        header.reserve(header_size_);
 
-    file.open("res/data/save", std::ios::trunc);
+        header.insert(end(header), save_magic_, save_magic_ + 4);
+
+        write_u32(save_version_,                                header);
+        write_u32(uint32_t(buffer_.size()),                     header);
+        write_u32(checksum(buffer_.data(), buffer_.size()),     header);
+
+        ASSERT(header.size() == header_size_);
+
+        buffer_.insert(begin(buffer_), begin(header), end(header));
+    }
+
+    std::ofstream file(save_path_, std::ios::trunc | std::ios::binary);
 
     if (file.is_open())
     {
-        for (size_t i = 0; i < lines_.size(); ++i)
-        {
-            file << lines_[i];
-
-            if (i != lines_.size() - 1)
-            {
-                file << std::endl;
-            }
-        }
+        file.write((const char*)buffer_.data(), buffer_.size());
 
         file.close();
     }
 }
 
-void read_file()
+// Reads the header of the save file, returns false if the file is missing,
+// empty, or of an unsupported format. On success, the read position is set to
+// the start of the data.
+bool read_header(std::ifstream& file)
 {
-    std::ifstream file("res/data/save");
+    uint8_t header[header_size_];
 
-    if (file.is_open())
+    file.read((char*)header, header_size_);
+
+    if (!file || (size_t)file.gcount() != header_size_)
+    {
+        return false;
+    }
+
+    if (!std::equal(save_magic_, save_magic_ + 4, (const char*)header))
     {
-        std::string current_line = "";
+        return false;
+    }
 
-        while (getline(file, current_line))
-        {
-            lines_.push_back(current_line);
-        }
+    return read_u32(header + 4) == save_version_;
+}
 
-        file.close();
+// Reads the whole save file to the buffer, returns false if the file could not
+// be read, or if it is not a valid save file (including checksum mismatch)
+bool read_file()
+{
+    std::ifstream file(save_path_, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        TRACE << "Failed to open save file" << std::endl;
+
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+
+    const std::streamoff file_size = file.tellg();
+
+    file.seekg(0, std::ios::beg);
+
+    if ((file_size <= (std::streamoff)header_size_) || !read_header(file))
+    {
+        TRACE << "Unsupported save file" << std::endl;
+
+        return false;
+    }
+
+    buffer_.resize((size_t)file_size);
+
+    file.seekg(0, std::ios::beg);
+
+    file.read((char*)buffer_.data(), file_size);
+
+    if (!file || (file.gcount() != file_size))
+    {
+        TRACE << "Failed to read save file" << std::endl;
+
+        return false;
     }
-    else // Could not open save file
+
+    file.close();
+
+    const uint32_t data_size    = read_u32(&buffer_[8]);
+    const uint32_t data_hash    = read_u32(&buffer_[12]);
+
+    // Save file corruption check
+    if ((data_size != buffer_.size() - header_size_) ||
+        (checksum(&buffer_[header_size_], data_size) != data_hash))
     {
-        ASSERT(false && "Failed to open save file");
+        TRACE << "Save file checksum mismatch" << std::endl;
+
+        return false;
     }
+
+    read_pos_ = header_size_;
+
+    return true;
 }
 
 } // namespace
 
 void init()
 {
-    lines_.clear();
+    buffer_.clear();
+
+    read_pos_ = 0;
+
+    is_corrupt_ = false;
 
 #ifndef NDEBUG
     state_ = State::stopped;
@@ -158,12 +353,12 @@ void save_game()
 {
 #ifndef NDEBUG
     ASSERT(state_ == State::stopped);
-    ASSERT(lines_.empty());
+    ASSERT(buffer_.empty());
 
     state_ = State::saving;
 #endif // NDEBUG
 
-    // Tell all modules to append to the save lines (via this modules store
+    // Tell all modules to append to the save buffer (via this modules store
     // functions)
     save_modules();
 
@@ -171,52 +366,69 @@ void save_game()
     state_ = State::stopped;
 #endif // NDEBUG
 
-    // Write the save lines to the save file
+    // Write the save buffer to the save file
     write_file();
 
-    lines_.clear();
+    buffer_.clear();
 }
 
-void load_game()
+bool load_game()
 {
 #ifndef NDEBUG
     ASSERT(state_ == State::stopped);
-    ASSERT(lines_.empty());
+    ASSERT(buffer_.empty());
 
     state_ = State::loading;
 #endif // NDEBUG
 
-    // Read the save file to the save lines
-    read_file();
+    is_corrupt_ = false;
+
+    // Read the save file to the save buffer
+    bool is_ok = read_file();
 
-    ASSERT(!lines_.empty());
+    if (is_ok)
+    {
+        // Tell all modules to set up their state from the save buffer (via the
+        // read functions of this module)
+        load_modules();
 
-    // Tell all modules to set up their state from the save lines (via the
-    // read functions of this module)
-    load_modules();
+        // Save file corruption check - all data should have been read
+        is_ok = !is_corrupt_ && (read_pos_ == buffer_.size());
+    }
 
 #ifndef NDEBUG
     state_ = State::stopped;
 #endif // NDEBUG
 
-    // Save file corruption check
-    ASSERT(lines_.empty());
+    buffer_.clear();
+
+    read_pos_ = 0;
+
+    is_corrupt_ = false;
+
+    if (!is_ok)
+    {
+        // NOTE: The save file is left as it is
+        return false;
+    }
 
     // Loading finished, write an empty save file to prevent reloading the game
     write_file();
+
+    return true;
 }
 
 bool is_save_available()
 {
-    std::ifstream file("res/data/save");
+    std::ifstream file(save_path_, std::ios::binary);
 
     if (file.good())
     {
-        const bool is_empty = file.peek() == std::ifstream::traits_type::eof();
+        const bool is_valid = read_header(file);
 
         file.close();
 
-        return !is_empty;
+        return is_valid;
     }
     else // Failed to open file
     {
@@ -227,49 +439,141 @@ bool is_save_available()
 
 void put_str(const std::string str)
 {
-#ifndef NDEBUG
-    ASSERT(state_ == State::saving);
-#endif // NDEBUG
+    put_tag(ValType::str);
+
+    write_u32(uint32_t(str.size()), buffer_);
 
-    lines_.push_back(str);
+    buffer_.insert(end(buffer_), begin(str), end(str));
 }
 
 void put_int(const int v)
 {
-    put_str(std::to_string(v));
+    put_tag(ValType::integer);
+
+    write_u32(uint32_t(v), buffer_);
 }
 
 void put_bool(const bool v)
 {
-    const std::string str = v ? "T" : "F";
+    put_tag(ValType::boolean);
+
+    buffer_.push_back(v ? 1 : 0);
+}
+
+void put_int_arr(const int* const arr, const size_t nr_elements)
+{
+    put_tag(ValType::int_arr);
 
-    put_str(str);
+    write_u32(uint32_t(nr_elements), buffer_);
+
+    buffer_.reserve(buffer_.size() + (nr_elements * 4));
+
+    for (size_t i = 0; i < nr_elements; ++i)
+    {
+        write_u32(uint32_t(arr[i]), buffer_);
+    }
+}
+
+void put_bool_arr(const bool* const arr, const size_t nr_elements)
+{
+    put_tag(ValType::bool_arr);
+
+    write_u32(uint32_t(nr_elements), buffer_);
+
+    for (size_t i = 0; i < nr_elements; ++i)
+    {
+        buffer_.push_back(arr[i] ? 1 : 0);
+    }
 }
 
 std::string get_str()
 {
-#ifndef NDEBUG
-    ASSERT(state_ == State::loading);
-#endif // NDEBUG
+    if (!get_tag(ValType::str, 4))
+    {
+        return "";
+    }
+
+    const size_t len = get_u32();
 
     // Save file corruption check
-    ASSERT(!lines_.empty());
+    if (len > (buffer_.size() - read_pos_))
+    {
+        is_corrupt_ = true;
+
+        return "";
+    }
 
-    const std::string str = lines_.front();
+    const char* const str_begin = (const char*)&buffer_[read_pos_];
 
-    lines_.erase(begin(lines_));
+    read_pos_ += len;
 
-    return str;
+    return std::string(str_begin, len);
 }
 
 int get_int()
 {
-    return to_int(get_str());
+    if (!get_tag(ValType::integer, 4))
+    {
+        return 0;
+    }
+
+    return int(get_u32());
 }
 
 bool get_bool()
 {
-    return get_str() == "T";
+    if (!get_tag(ValType::boolean, 1))
+    {
+        return false;
+    }
+
+    return buffer_[read_pos_++] != 0;
+}
+
+void get_int_arr(int* const arr, const size_t nr_elements)
+{
+    if (!get_tag(ValType::int_arr, 4 + (nr_elements * 4)))
+    {
+        return;
+    }
+
+    const size_t nr_saved = get_u32();
+
+    // Save file corruption check
+    if (nr_saved != nr_elements)
+    {
+        is_corrupt_ = true;
+
+        return;
+    }
+
+    for (size_t i = 0; i < nr_elements; ++i)
+    {
+        arr[i] = int(get_u32());
+    }
+}
+
+void get_bool_arr(bool* const arr, const size_t nr_elements)
+{
+    if (!get_tag(ValType::bool_arr, 4 + nr_elements))
+    {
+        return;
+    }
+
+    const size_t nr_saved = get_u32();
+
+    // Save file corruption check
+    if (nr_saved != nr_elements)
+    {
+        is_corrupt_ = true;
+
+        return;
+    }
+
+    for (size_t i = 0; i < nr_elements; ++i)
+    {
+        arr[i] = buffer_[read_pos_++] != 0;
+    }
 }
 
 } // save
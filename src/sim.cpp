@@ -0,0 +1,467 @@
+#include "sim.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include "init.hpp"
+#include "rl_utils.hpp"
+#include "config.hpp"
+#include "state.hpp"
+#include "map.hpp"
+#include "map_travel.hpp"
+#include "game_time.hpp"
+#include "actor_player.hpp"
+#include "player_bon.hpp"
+#include "properties.hpp"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif // _WIN32
+
+namespace sim
+{
+
+namespace
+{
+
+const std::string run_data_prefix = "run";
+
+typedef std::chrono::steady_clock Clock;
+
+double ms_since(const Clock::time_point& start)
+{
+    const auto diff = Clock::now() - start;
+
+    return std::chrono::duration<double, std::milli>(diff).count();
+}
+
+// States may be pushed during play (e.g. picking a trait on level up) - the
+// bot answers these immediately when they are updated. Any state still waiting
+// after that is waiting for input which will never come, so it is dropped.
+void run_pushed_states()
+{
+    if (states::is_empty())
+    {
+        return;
+    }
+
+    states::start();
+
+    states::update();
+
+    states::pop_all();
+}
+
+// Corresponds to GameState::on_start for a new game, with the intro level
+// skipped, and with character creation done like the bot does it
+void start_game()
+{
+    player_bon::pick_bg(rnd::element(player_bon::pickable_bgs()));
+
+    ActorDataT& d = map::player->data();
+
+    d.name_a = d.name_the = "Bot";
+
+    map::player->set_hp_and_spi_to_max();
+
+    map::player->mk_start_items();
+
+    map_travel::go_to_nxt();
+
+    map::player->update_fov();
+}
+
+const std::string result_str(const SimResult result)
+{
+    switch (result)
+    {
+    case SimResult::reached_max_dlvl:
+        return "reached";
+
+    case SimResult::died:
+        return "died";
+
+    case SimResult::turn_limit:
+        return "turn limit";
+    }
+
+    return "";
+}
+
+const std::string phase_str(const SimPhase phase)
+{
+    switch (phase)
+    {
+    case SimPhase::setup:
+        return "Setup";
+
+    case SimPhase::player:
+        return "Bot actions";
+
+    case SimPhase::mon:
+        return "Monster actions";
+
+    case SimPhase::lvl_transition:
+        return "Level transitions";
+
+    case SimPhase::END:
+        break;
+    }
+
+    return "";
+}
+
+} // namespace
+
+SimRunData run_one(const unsigned int seed, const SimParams& params)
+{
+    TRACE_FUNC_BEGIN;
+
+    SimRunData d;
+
+    d.seed = seed;
+
+    if (!config::is_bot_playing())
+    {
+        config::toggle_bot_playing();
+    }
+
+    const int max_dlvl = std::min(params.max_dlvl, dlvl_last);
+
+    auto start_time = Clock::now();
+
+    rnd::seed(seed);
+
+    // NOTE: The standard library shuffling uses the C random generator
+    srand(seed);
+
+    init::init_session();
+
+    start_game();
+
+    d.phase_ms[(size_t)SimPhase::setup] += ms_since(start_time);
+
+    while (true)
+    {
+        if (!map::player->is_alive())
+        {
+            d.result = SimResult::died;
+            break;
+        }
+
+        if (map::dlvl >= max_dlvl)
+        {
+            d.result = SimResult::reached_max_dlvl;
+            break;
+        }
+
+        if (game_time::turn_nr() >= params.max_turns)
+        {
+            d.result = SimResult::turn_limit;
+            break;
+        }
+
+        run_pushed_states();
+
+        //
+        // Let the current actor act (same as GameState::update, but without
+        // rendering between player turns)
+        //
+        Actor* const actor = game_time::current_actor();
+
+        const bool is_player = actor->is_player();
+
+        const int dlvl_before = map::dlvl;
+
+        start_time = Clock::now();
+
+        const bool allow_act = actor->prop_handler().allow_act();
+
+        const bool is_gibbed = actor->state() == ActorState::destroyed;
+
+        if (allow_act && !is_gibbed)
+        {
+            actor->act();
+        }
+        else // Actor cannot act
+        {
+            game_time::tick();
+        }
+
+        // NOTE: The actor may have been deleted at this point (e.g. monsters
+        //       are deleted when the player travels to a new level)
+
+        SimPhase phase = is_player ? SimPhase::player : SimPhase::mon;
+
+        if (map::dlvl != dlvl_before)
+        {
+            phase = SimPhase::lvl_transition;
+        }
+
+        d.phase_ms[(size_t)phase] += ms_since(start_time);
+    }
+
+    d.dlvl = map::dlvl;
+
+    d.nr_turns = game_time::turn_nr();
+
+    states::pop_all();
+
+    init::cleanup_session();
+
+    TRACE_FUNC_END;
+
+    return d;
+}
+
+SimReport run(const SimParams& params)
+{
+    SimReport report;
+
+    const auto start_time = Clock::now();
+
+    for (int i = 0; i < params.nr_runs; ++i)
+    {
+        const unsigned int seed = params.seed + (unsigned int)i;
+
+        report.runs.push_back(run_one(seed, params));
+    }
+
+    report.total_ms = ms_since(start_time);
+
+    return report;
+}
+
+SimReport run_parallel(const SimParams& params, const std::string& worker_exe)
+{
+    TRACE_FUNC_BEGIN;
+
+    SimReport report;
+
+    const auto start_time = Clock::now();
+
+    const int nr_jobs = std::max(1, std::min(params.nr_jobs, params.nr_runs));
+
+    //
+    // Launch all workers first - they run concurrently while we wait for the
+    // output of each worker in turn below
+    //
+    std::vector<FILE*> workers;
+
+    int run_idx = 0;
+
+    for (int job = 0; job < nr_jobs; ++job)
+    {
+        // Spread the remaining runs evenly over the remaining workers
+        const int nr_runs_job = (params.nr_runs - run_idx) / (nr_jobs - job);
+
+        std::stringstream cmd;
+
+        cmd << "\"" << worker_exe << "\" --worker "
+            << (params.seed + (unsigned int)run_idx) << " "
+            << nr_runs_job << " "
+            << params.max_dlvl;
+
+        FILE* const pipe = popen(cmd.str().c_str(), "r");
+
+        if (pipe)
+        {
+            workers.push_back(pipe);
+        }
+        else // Failed to launch worker
+        {
+            TRACE << "Failed to launch worker: " << cmd.str() << std::endl;
+        }
+
+        run_idx += nr_runs_job;
+    }
+
+    for (FILE* const pipe : workers)
+    {
+        std::string output = "";
+
+        char buffer[256];
+
+        while (fgets(buffer, sizeof(buffer), pipe))
+        {
+            output += buffer;
+        }
+
+        pclose(pipe);
+
+        std::istringstream output_stream(output);
+
+        std::string line;
+
+        while (std::getline(output_stream, line))
+        {
+            SimRunData d;
+
+            if (read_run_data(line, d))
+            {
+                report.runs.push_back(d);
+            }
+        }
+    }
+
+    // Present the runs in the same order as a single process run would
+    std::sort(begin(report.runs),
+              end(report.runs),
+              [](const SimRunData& d1, const SimRunData& d2)
+    {
+        return d1.seed < d2.seed;
+    });
+
+    report.nr_runs_lost = params.nr_runs - (int)report.runs.size();
+
+    report.total_ms = ms_since(start_time);
+
+    TRACE_FUNC_END;
+
+    return report;
+}
+
+void write_run_data(const SimRunData& d, std::ostream& out)
+{
+    out << run_data_prefix
+        << " " << d.seed
+        << " " << (int)d.result
+        << " " << d.dlvl
+        << " " << d.nr_turns
+        << std::fixed << std::setprecision(3);
+
+    for (size_t i = 0; i < (size_t)SimPhase::END; ++i)
+    {
+        out << " " << d.phase_ms[i];
+    }
+
+    out << std::endl;
+}
+
+bool read_run_data(const std::string& line, SimRunData& d)
+{
+    std::istringstream in(line);
+
+    std::string prefix = "";
+
+    int result = 0;
+
+    in >> prefix >> d.seed >> result >> d.dlvl >> d.nr_turns;
+
+    for (size_t i = 0; i < (size_t)SimPhase::END; ++i)
+    {
+        in >> d.phase_ms[i];
+    }
+
+    // NOTE: Any lines not containing run data are ignored (e.g. trace output)
+    if (in.fail() || (prefix != run_data_prefix))
+    {
+        return false;
+    }
+
+    d.result = SimResult(result);
+
+    return true;
+}
+
+void print_report(const SimReport& report, std::ostream& out)
+{
+    int nr_died = 0;
+    int nr_reached = 0;
+    int nr_turn_limit = 0;
+    long nr_turns_tot = 0;
+    long nr_dlvls_tot = 0;
+
+    double phase_ms_tot[(size_t)SimPhase::END] = {};
+
+    out << std::left
+        << std::setw(12) << "Seed"
+        << std::setw(12) << "Result"
+        << std::setw(8)  << "Dlvl"
+        << std::setw(10) << "Turns"
+        << "Time (ms)" << std::endl;
+
+    for (const SimRunData& run : report.runs)
+    {
+        double run_ms = 0.0;
+
+        for (size_t i = 0; i < (size_t)SimPhase::END; ++i)
+        {
+            run_ms += run.phase_ms[i];
+
+            phase_ms_tot[i] += run.phase_ms[i];
+        }
+
+        out << std::setw(12) << run.seed
+            << std::setw(12) << result_str(run.result)
+            << std::setw(8)  << run.dlvl
+            << std::setw(10) << run.nr_turns
+            << std::fixed << std::setprecision(1) << run_ms
+            << std::endl;
+
+        switch (run.result)
+        {
+        case SimResult::reached_max_dlvl:
+            ++nr_reached;
+            break;
+
+        case SimResult::died:
+            ++nr_died;
+            break;
+
+        case SimResult::turn_limit:
+            ++nr_turn_limit;
+            break;
+        }
+
+        nr_turns_tot += run.nr_turns;
+        nr_dlvls_tot += run.dlvl;
+    }
+
+    const double total_s = report.total_ms / 1000.0;
+
+    const double turns_per_s = (total_s > 0.0) ? (nr_turns_tot / total_s) : 0.0;
+    const double dlvls_per_s = (total_s > 0.0) ? (nr_dlvls_tot / total_s) : 0.0;
+
+    out << std::endl
+        << "Runs:        " << report.runs.size() << std::endl
+        << "Lost:        " << report.nr_runs_lost << " (crashed)" << std::endl
+        << "Reached:     " << nr_reached << std::endl
+        << "Deaths:      " << nr_died << std::endl
+        << "Turn limit:  " << nr_turn_limit << std::endl
+        << "Total time:  " << std::setprecision(1) << report.total_ms << " ms"
+        << std::endl
+        << "Turns:       " << nr_turns_tot
+        << " (" << std::setprecision(1) << turns_per_s << " turns/s)"
+        << std::endl
+        << "Dlvls:       " << nr_dlvls_tot
+        << " (" << std::setprecision(3) << dlvls_per_s << " dlvls/s)"
+        << std::endl
+        << std::endl
+        << "Phase timings:" << std::endl;
+
+    double phase_ms_sum = 0.0;
+
+    for (size_t i = 0; i < (size_t)SimPhase::END; ++i)
+    {
+        phase_ms_sum += phase_ms_tot[i];
+    }
+
+    for (size_t i = 0; i < (size_t)SimPhase::END; ++i)
+    {
+        const double pct =
+            (phase_ms_sum > 0.0) ? ((phase_ms_tot[i] * 100.0) / phase_ms_sum) :
+            0.0;
+
+        out << "  " << std::setw(20) << phase_str(SimPhase(i))
+            << std::setprecision(1) << phase_ms_tot[i] << " ms"
+            << " (" << pct << "%)" << std::endl;
+    }
+}
+
+} // sim
@@ -0,0 +1,182 @@
+#include "init.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "rl_utils.hpp"
+#include "sim.hpp"
+#include "bench.hpp"
+
+namespace
+{
+
+void print_usage()
+{
+    std::cout << "Usage: ia-sim [-j jobs] [seed] [number of runs] [max dlvl]"
+              << std::endl
+              << "       ia-sim --bench"
+              << std::endl
+              << std::endl
+              << "  -j jobs   Number of worker processes to spread the runs "
+              << "over (0 = one per core)"
+              << std::endl
+              << "  --bench   Run the micro benchmarks instead of any games"
+              << std::endl;
+}
+
+bool parse_int(const char* const str, int& out)
+{
+    char* end = nullptr;
+
+    const long v = strtol(str, &end, 10);
+
+    if ((end == str) || (*end != '\0'))
+    {
+        return false;
+    }
+
+    out = int(v);
+
+    return true;
+}
+
+} // namespace
+
+#ifdef _WIN32
+#undef main
+#endif
+int main(int argc, char* argv[])
+{
+    TRACE_FUNC_BEGIN;
+
+    SimParams params;
+
+    // Worker processes only write the run data for the parent process to read
+    bool is_worker = false;
+
+    int arg_idx = 1;
+
+    if ((arg_idx < argc) && (strcmp(argv[arg_idx], "--bench") == 0))
+    {
+        if ((arg_idx + 1) != argc)
+        {
+            print_usage();
+
+            return EXIT_FAILURE;
+        }
+
+        init::init_game();
+
+        bench::run(std::cout);
+
+        init::cleanup_game();
+
+        TRACE_FUNC_END;
+
+        return EXIT_SUCCESS;
+    }
+
+    if ((arg_idx < argc) && (strcmp(argv[arg_idx], "--worker") == 0))
+    {
+        is_worker = true;
+
+        ++arg_idx;
+    }
+    else if ((arg_idx < argc) && (strcmp(argv[arg_idx], "-j") == 0))
+    {
+        if (((arg_idx + 1) >= argc) ||
+            !parse_int(argv[arg_idx + 1], params.nr_jobs) ||
+            (params.nr_jobs < 0))
+        {
+            print_usage();
+
+            return EXIT_FAILURE;
+        }
+
+        if (params.nr_jobs == 0)
+        {
+            const int nr_cores = (int)std::thread::hardware_concurrency();
+
+            params.nr_jobs = std::max(1, nr_cores);
+        }
+
+        arg_idx += 2;
+    }
+
+    int args[3] =
+    {
+        (int)params.seed,
+        params.nr_runs,
+        params.max_dlvl
+    };
+
+    if ((argc - arg_idx) > 3)
+    {
+        print_usage();
+
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; arg_idx < argc; ++i, ++arg_idx)
+    {
+        if (!parse_int(argv[arg_idx], args[i]))
+        {
+            print_usage();
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    params.seed     = (unsigned int)args[0];
+    params.nr_runs  = args[1];
+    params.max_dlvl = args[2];
+
+    if ((params.nr_runs < 1) || (params.max_dlvl < 1))
+    {
+        print_usage();
+
+        return EXIT_FAILURE;
+    }
+
+    if (params.nr_jobs > 1)
+    {
+        // The games are run by worker processes (running this executable)
+        const SimReport report = sim::run_parallel(params, argv[0]);
+
+        sim::print_report(report, std::cout);
+
+        TRACE_FUNC_END;
+
+        return (report.nr_runs_lost == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // NOTE: IO is never initialized - everything runs headless
+    init::init_game();
+
+    if (is_worker)
+    {
+        for (int i = 0; i < params.nr_runs; ++i)
+        {
+            const unsigned int seed = params.seed + (unsigned int)i;
+
+            const SimRunData d = sim::run_one(seed, params);
+
+            sim::write_run_data(d, std::cout);
+        }
+    }
+    else // Not a worker process
+    {
+        const SimReport report = sim::run(params);
+
+        sim::print_report(report, std::cout);
+    }
+
+    init::cleanup_game();
+
+    TRACE_FUNC_END;
+
+    return EXIT_SUCCESS;
+}
@@ -9,6 +9,7 @@
 #include "actor_mon.hpp"
 #include "game_time.hpp"
 #include "map_parsing.hpp"
+#include "flood_workspace.hpp"
 
 // -----------------------------------------------------------------------------
 // Sound
@@ -62,9 +63,43 @@ namespace
 
 int nr_snd_msg_printed_current_turn_;
 
-bool is_snd_heard_at_range(const int range, const Snd& snd)
+FloodWorkspace flood_;
+
+// Cells blocking sound - this only depends on the terrain, so it is only
+// updated when the terrain has changed
+bool snd_blocked_[map_w][map_h];
+
+bool is_snd_blocked_valid_ = false;
+
+int snd_blocked_terrain_revision_ = 0;
+
+void update_snd_blocked()
+{
+    const int terrain_revision = map::terrain_revision();
+
+    if (is_snd_blocked_valid_ &&
+        (snd_blocked_terrain_revision_ == terrain_revision))
+    {
+        return;
+    }
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            snd_blocked_[x][y] =
+                map::terrain_flags[x][y] & feature_flag::blocks_sound;
+        }
+    }
+
+    is_snd_blocked_valid_ = true;
+
+    snd_blocked_terrain_revision_ = terrain_revision;
+}
+
+int snd_max_dist(const Snd& snd)
 {
-    return range <= (snd.is_loud() ? snd_dist_loud : snd_dist_normal);
+    return snd.is_loud() ? snd_dist_loud : snd_dist_normal;
 }
 
 } // namespace
@@ -78,48 +113,48 @@ void run(Snd snd)
 {
     ASSERT(snd.msg() != " ");
 
-    bool blocked[map_w][map_h];
-
-    for (int x = 0; x < map_w; ++x)
-    {
-        for (int y = 0; y < map_h; ++y)
-        {
-            const auto f  = map::cells[x][y].rigid;
+    const P& origin = snd.origin();
 
-            blocked[x][y] = !f->is_sound_passable();
-        }
-    }
+    const int max_dist = snd_max_dist(snd);
 
-    const P& origin = snd.origin();
+    // Only the cells within hearing range of the origin can be reached
+    const R area(std::max(1,            origin.x - max_dist),
+                 std::max(1,            origin.y - max_dist),
+                 std::min(map_w - 2,    origin.x + max_dist),
+                 std::min(map_h - 2,    origin.y + max_dist));
 
-    // Never block the origin - we want to be able to run the sound from e.g. a
-    // closing door, after it was closed (and we don't want this to depend on
-    // the floodfill algorithm, so we explicitly set the origin to free here)
-    blocked[origin.x][origin.y] = false;
+    update_snd_blocked();
 
-    int flood[map_w][map_h];
+    // NOTE: The origin is always reached, even if it blocks sound - we want to
+    //       be able to run the sound from e.g. a closing door, after it was
+    //       closed
+    flood_.run(origin,
+               snd_blocked_,
+               max_dist,
+               true,
+               area);
 
-    floodfill(origin,
-              blocked,
-              flood,
-              999,
-              P(-1, -1),
-              true);
+    // NOTE: The actors hearing the sound are collected before running any
+    //       effects of hearing it, since these may emit new sounds
+    std::vector< std::pair<Actor*, int> > hearing_actors;
 
-    flood[origin.x][origin.y] = 0;
+    for (const P& p : flood_.reached())
+    {
+        for (Actor* actor : game_time::actors_at_pos(p))
+        {
+            hearing_actors.push_back({actor, flood_.dist(p)});
+        }
+    }
 
-    for (Actor* actor : game_time::actors)
+    for (const auto& hearing_actor : hearing_actors)
     {
-        const int flood_val_at_actor = flood[actor->pos.x][actor->pos.y];
+        Actor* const actor = hearing_actor.first;
+
+        const int flood_val_at_actor = hearing_actor.second;
 
         const bool is_origin_seen_by_player =
             map::cells[origin.x][origin.y].is_seen_by_player;
 
-        if (!is_snd_heard_at_range(flood_val_at_actor, snd))
-        {
-            continue;
-        }
-
         if (actor->is_player())
         {
             if (is_origin_seen_by_player &&
@@ -145,11 +180,7 @@ void run(Snd snd)
                 }
             }
 
-            const int snd_max_dist =
-                snd.is_loud() ?
-                snd_dist_loud : snd_dist_normal;
-
-            const int pct_dist = (flood_val_at_actor * 100) / snd_max_dist;
+            const int pct_dist = (flood_val_at_actor * 100) / max_dist;
 
             const P offset = (origin - player_pos).signs();
 
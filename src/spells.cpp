@@ -19,7 +19,7 @@
 #include "inventory.hpp"
 #include "map_parsing.hpp"
 #include "line_calc.hpp"
-#include "sdl_base.hpp"
+#include "animation.hpp"
 #include "player_bon.hpp"
 #include "game.hpp"
 #include "explosion.hpp"
@@ -467,29 +467,23 @@ void SpellDarkbolt::run_effect(Actor* const caster, const int skill) const
                              false,
                              line);
 
-    states::draw();
+    AnimScript script;
 
     const size_t line_size = line.size();
 
     for (size_t i = 1; i < line_size; ++i)
     {
-        const P& p = line[i];
+        // The bolt leaves a trail behind it
+        const bool draw_map_before = (i == 1);
 
-        if (config::is_tiles_mode())
-        {
-            io::draw_tile(TileId::blast1, Panel::map, p, clr_magenta);
-        }
-        else
-        {
-            io::draw_glyph('*', Panel::map, p, clr_magenta);
-        }
-
-        io::update_screen();
+        script.add_frame(config::delay_projectile_draw(), draw_map_before);
 
-        sdl_base::sleep(config::delay_projectile_draw());
+        script.add_cell(line[i], TileId::blast1, '*', clr_magenta);
     }
 
-    io::draw_blast_at_cells({target->pos}, clr_magenta);
+    script.add_blast({target->pos}, clr_magenta, config::delay_explosion());
+
+    anim::play(script);
 
     Clr msg_clr = clr_msg_good;
 
@@ -1015,7 +1009,7 @@ void SpellAnimWpns::run_effect(Actor* const caster, const int skill) const
         {
             for (int y = 0; y < map_h; ++y)
             {
-                Cell& cell = map::cells[x][y];
+                Cell cell = map::cells[x][y];
 
                 Item* const item = cell.item;
 
@@ -1053,7 +1047,7 @@ void SpellAnimWpns::run_effect(Actor* const caster, const int skill) const
 
     for (const P& p : positions_to_anim)
     {
-        Cell& cell = map::cells[p.x][p.y];
+        Cell cell = map::cells[p.x][p.y];
 
         Item* const item = cell.item;
 
@@ -1268,7 +1262,7 @@ void SpellSearching::run_effect(Actor* const caster, const int skill) const
     {
         for (int x = x0; x <= x1; ++x)
         {
-            auto& cell = map::cells[x][y];
+            auto cell = map::cells[x][y];
 
             // Detect item here?
             if (cell.item)
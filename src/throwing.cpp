@@ -19,7 +19,7 @@
 #include "attack.hpp"
 #include "line_calc.hpp"
 #include "player_bon.hpp"
-#include "sdl_base.hpp"
+#include "animation.hpp"
 #include "feature_rigid.hpp"
 #include "feature_mob.hpp"
 
@@ -66,26 +66,19 @@ void player_throw_lit_explosive(const P& aim_cell)
     {
         const auto  clr = explosive->ignited_projectile_clr();
 
+        AnimScript script;
+
         for (const P& p : path)
         {
-            states::draw();
-
             if (map::cells[p.x][p.y].is_seen_by_player)
             {
-                if (config::is_tiles_mode())
-                {
-                    io::draw_tile(explosive->tile(), Panel::map, p, clr);
-                }
-                else // Text mode
-                {
-                    io::draw_glyph(explosive->glyph(), Panel::map, p, clr);
-                }
-
-                io::update_screen();
+                script.add_frame(config::delay_projectile_draw());
 
-                sdl_base::sleep(config::delay_projectile_draw());
+                script.add_cell(p, explosive->tile(), explosive->glyph(), clr);
             }
         }
+
+        anim::play(script);
     }
 
     if (!map::cells[end_pos.x][end_pos.y].rigid->is_bottomless())
@@ -163,6 +156,10 @@ void throw_item(Actor& actor_throwing,
 
     states::draw();
 
+    // The flight is recorded while the throw is resolved, and played back
+    // before any effects of the landing (e.g. potions shattering)
+    AnimScript script;
+
     bool is_actor_hit = false;
 
     const Clr item_clr = item_thrown.clr();
@@ -175,8 +172,6 @@ void throw_item(Actor& actor_throwing,
 
     for (size_t path_idx = 1; path_idx < path.size(); ++path_idx)
     {
-        states::draw();
-
         // Have we gone out of range?
         {
             const int max_range = item_thrown.data().ranged.max_range;
@@ -220,7 +215,9 @@ void throw_item(Actor& actor_throwing,
                         item_clr :
                         clr_red_lgt;
 
-                    io::draw_blast_at_cells({pos}, hit_clr);
+                    script.add_blast({pos},
+                                     hit_clr,
+                                     config::delay_explosion());
                 }
 
                 static_cast<Mon*>(actor_here)->set_player_aware_of_me();
@@ -268,6 +265,8 @@ void throw_item(Actor& actor_throwing,
                 //
                 if (is_potion)
                 {
+                    anim::play(script);
+
                     Potion* const potion = static_cast<Potion*>(&item_thrown);
 
                     potion->on_collide(pos, actor_here);
@@ -301,24 +300,12 @@ void throw_item(Actor& actor_throwing,
 
         if (map::cells[pos.x][pos.y].is_seen_by_player)
         {
-            if (config::is_tiles_mode())
-            {
-                io::draw_tile(item_thrown.tile(),
-                                  Panel::map,
-                                  pos,
-                                  item_clr);
-            }
-            else // Text mode
-            {
-                io::draw_glyph(item_thrown.glyph(),
-                                   Panel::map,
-                                   pos,
-                                   item_clr);
-            }
+            script.add_frame(config::delay_projectile_draw());
 
-            io::update_screen();
-
-            sdl_base::sleep(config::delay_projectile_draw());
+            script.add_cell(pos,
+                            item_thrown.tile(),
+                            item_thrown.glyph(),
+                            item_clr);
         }
 
         if ((pos == tgt_pos) &&
@@ -328,6 +315,8 @@ void throw_item(Actor& actor_throwing,
         }
     } // path loop
 
+    anim::play(script);
+
     // If potion, collide it on the landscape
     if (item_thrown_data.type == ItemType::potion)
     {
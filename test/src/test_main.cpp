@@ -3,7 +3,11 @@
 #include "UnitTest++.h"
 
 #include <climits>
+#include <cmath>
+#include <fstream>
+#include <iterator>
 #include <string>
+#include <vector>
 
 #include <SDL.h>
 
@@ -21,6 +25,7 @@
 #include "map_parsing.hpp"
 #include "fov.hpp"
 #include "line_calc.hpp"
+#include "light_srcs.hpp"
 #include "saving.hpp"
 #include "inventory.hpp"
 #include "player_spells.hpp"
@@ -29,8 +34,14 @@
 #include "item_device.hpp"
 #include "feature_rigid.hpp"
 #include "feature_trap.hpp"
+#include "feature_door.hpp"
+#include "feature_mob.hpp"
+#include "game_time.hpp"
 #include "drop.hpp"
 #include "map_travel.hpp"
+#include "flood_workspace.hpp"
+#include "ai.hpp"
+#include "animation.hpp"
 
 struct BasicFixture
 {
@@ -40,7 +51,7 @@ struct BasicFixture
         init::init_session();
 
         map::player->mk_start_items();
-        map::player->pos = P(1, 1);
+        map::player->set_pos(P(1, 1));
 
         // Because map generation is not run
         map::reset_map();
@@ -483,6 +494,155 @@ TEST_FIXTURE(BasicFixture, line_calculation)
     CHECK(!delta_line);
 }
 
+namespace
+{
+
+// The original line walker, taking steps of 0.04 cells with floating point
+// math - the integer line tracing must produce exactly the same cells
+void calc_line_by_float_steps(const P& origin,
+                              const P& tgt,
+                              const bool should_stop_at_target,
+                              const int king_dist_limit,
+                              const bool allow_outside_map,
+                              std::vector<P>& line_ref)
+{
+    line_ref.clear();
+
+    if (tgt == origin)
+    {
+        line_ref.push_back(origin);
+        return;
+    }
+
+    const double delta_x_db = double(tgt.x - origin.x);
+    const double delta_y_db = double(tgt.y - origin.y);
+
+    const double hypot_db =
+        sqrt((delta_x_db * delta_x_db) + (delta_y_db * delta_y_db));
+
+    const double x_incr_db = (delta_x_db / hypot_db);
+    const double y_incr_db = (delta_y_db / hypot_db);
+
+    double current_x_db = double(origin.x) + 0.5;
+    double current_y_db = double(origin.y) + 0.5;
+
+    P current_pos = P(int(current_x_db), int(current_y_db));
+
+    const double step_size_db = 0.04;
+
+    for (double i = 0.0; i <= 9999.0; i += step_size_db)
+    {
+        current_x_db += x_incr_db * step_size_db;
+        current_y_db += y_incr_db * step_size_db;
+
+        current_pos.set(floor(current_x_db), floor(current_y_db));
+
+        if (!allow_outside_map && !map::is_pos_inside_map(current_pos))
+        {
+            return;
+        }
+
+        if (line_ref.empty() || (line_ref.back() != current_pos))
+        {
+            line_ref.push_back(current_pos);
+        }
+
+        if (should_stop_at_target && (current_pos == tgt))
+        {
+            return;
+        }
+
+        if (king_dist(origin, current_pos) >= king_dist_limit)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+TEST_FIXTURE(BasicFixture, line_calc_same_as_float_steps)
+{
+    std::vector<P> expected;
+    std::vector<P> line;
+
+    int nr_mismatches = 0;
+
+    auto check_line = [&](const P& origin,
+                          const P& tgt,
+                          const bool should_stop_at_target,
+                          const int king_dist_limit,
+                          const bool allow_outside_map)
+    {
+        calc_line_by_float_steps(origin,
+                                 tgt,
+                                 should_stop_at_target,
+                                 king_dist_limit,
+                                 allow_outside_map,
+                                 expected);
+
+        line_calc::calc_new_line(origin,
+                                 tgt,
+                                 should_stop_at_target,
+                                 king_dist_limit,
+                                 allow_outside_map,
+                                 line);
+
+        if (line != expected)
+        {
+            ++nr_mismatches;
+        }
+    };
+
+    const P map_center(map_w / 2, map_h / 2);
+
+    // All deltas covered by the stored delta lines
+    for (int dx = -(map_w - 1); dx < map_w; ++dx)
+    {
+        for (int dy = -(map_h - 1); dy < map_h; ++dy)
+        {
+            const P tgt(map_center + P(dx, dy));
+
+            check_line(map_center, tgt, true, 999, true);
+
+            // Limited by travel distance (e.g. the FOV lines)
+            check_line(map_center, tgt, false, fov_std_radi_int, true);
+        }
+    }
+
+    // Lines stopped by the map edge, from the center and the corners
+    const std::vector<P> origins =
+    {
+        map_center,
+        P(1, 1),
+        P(map_w - 2, 1),
+        P(1, map_h - 2),
+        P(map_w - 2, map_h - 2)
+    };
+
+    for (const P& origin : origins)
+    {
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                check_line(origin, P(x, y), false, 999, false);
+                check_line(origin, P(x, y), true, 999, false);
+            }
+        }
+    }
+
+    // A sample of deltas beyond the stored delta lines
+    for (int i = 0; i < 500; ++i)
+    {
+        const P tgt(rnd::range(-400, 400), rnd::range(-400, 400));
+
+        check_line(map_center, tgt, true, 999, true);
+    }
+
+    CHECK_EQUAL(0, nr_mismatches);
+}
+
 TEST_FIXTURE(BasicFixture, fov)
 {
     bool blocked[map_w][map_h] = {};
@@ -490,7 +650,7 @@ TEST_FIXTURE(BasicFixture, fov)
     const int x = map_w_half;
     const int y = map_h_half;
 
-    map::player->pos = P(x, y);
+    map::player->set_pos(P(x, y));
 
     LosResult fov[map_w][map_h];
 
@@ -531,6 +691,91 @@ TEST_FIXTURE(BasicFixture, fov)
     CHECK(fov[x - r + 1][y + r - 1].is_blocked_hard);
 }
 
+TEST_FIXTURE(BasicFixture, fov_same_result_as_single_cell_check)
+{
+    bool blocked[map_w][map_h];
+
+    LosResult fov[map_w][map_h];
+
+    // Random maps with walls, darkness and light, and the origin anywhere
+    // (including next to the map edges)
+    for (int i = 0; i < 200; ++i)
+    {
+        const int wall_pct  = rnd::range(0, 50);
+        const int drk_pct   = rnd::range(0, 100);
+        const int lit_pct   = rnd::range(0, 100);
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                blocked[x][y] = rnd::percent(wall_pct);
+
+                map::cells[x][y].is_dark    = rnd::percent(drk_pct);
+                map::cells[x][y].is_lit     = rnd::percent(lit_pct);
+            }
+        }
+
+        const P p0(rnd::range(0, map_w - 1), rnd::range(0, map_h - 1));
+
+        fov::run(p0, blocked, fov);
+
+        const R r = fov::get_fov_rect(p0);
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                const P p(x, y);
+
+                LosResult expected;
+
+                if (p == p0)
+                {
+                    expected.is_blocked_hard = false;
+                }
+                else if (is_pos_inside(p, r))
+                {
+                    expected = fov::check_cell(p0, p, blocked);
+                }
+                else // Outside the FOV rect
+                {
+                    expected.is_blocked_hard = true;
+                }
+
+                CHECK_EQUAL(expected.is_blocked_hard,   fov[x][y].is_blocked_hard);
+                CHECK_EQUAL(expected.is_blocked_by_drk, fov[x][y].is_blocked_by_drk);
+            }
+        }
+    }
+
+    // Wall right next to the origin - the wall itself is seen, but nothing
+    // straight behind it
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            blocked[x][y] = false;
+        }
+    }
+
+    const P p0(map_w_half, map_h_half);
+
+    const R r = fov::get_fov_rect(p0);
+
+    blocked[p0.x + 1][p0.y] = true;
+
+    fov::run(p0, blocked, fov);
+
+    CHECK(!fov[p0.x + 1][p0.y].is_blocked_hard);
+
+    for (int x = p0.x + 2; x <= r.p1.x; ++x)
+    {
+        CHECK(fov[x][p0.y].is_blocked_hard);
+        CHECK(fov::check_cell(p0, P(x, p0.y), blocked).is_blocked_hard);
+    }
+}
+
 TEST_FIXTURE(BasicFixture, light_map)
 {
     // Put walls on the edge of the map, and floor in all other cells, and make
@@ -541,7 +786,7 @@ TEST_FIXTURE(BasicFixture, light_map)
         {
             const P p(x, y);
 
-            Cell& cell = map::cells[p.x][p.y];
+            Cell cell = map::cells[p.x][p.y];
 
             cell.is_dark    = true;
             cell.is_lit     = false;
@@ -557,7 +802,7 @@ TEST_FIXTURE(BasicFixture, light_map)
         }
     }
 
-    map::player->pos.set(40, 12);
+    map::player->set_pos(P(40, 12));
 
     const P burn_pos(40, 10);
 
@@ -596,6 +841,161 @@ TEST_FIXTURE(BasicFixture, light_map)
     CHECK(map::cells[burn_pos.x + 1][burn_pos.y - 1].is_dark);
 }
 
+TEST_FIXTURE(BasicFixture, actor_and_mob_lookup_per_cell)
+{
+    const P p0(20, 10);
+    const P p1(21, 10);
+
+    Actor* const corpse = actor_factory::mk(ActorId::rat, p0);
+
+    corpse->die(false, false, false);
+
+    Actor* const mon = actor_factory::mk(ActorId::rat, p0);
+
+    CHECK(map::actor_at_pos(p0) == mon);
+    CHECK(map::actor_at_pos(p0, ActorState::corpse) == corpse);
+    CHECK(!map::actor_at_pos(p1));
+
+    mon->set_pos(p1);
+
+    CHECK(!map::actor_at_pos(p0));
+    CHECK(map::actor_at_pos(p1) == mon);
+    CHECK_EQUAL(1, int(game_time::actors_at_pos(p0).size()));
+
+    game_time::erase_actor(mon);
+
+    CHECK(!map::actor_at_pos(p1));
+    CHECK(game_time::actors_at_pos(p1).empty());
+
+    Mob* const smoke = new Smoke(p0, 10);
+
+    game_time::add_mob(smoke);
+
+    CHECK(map::first_mob_at_pos(p0) == smoke);
+
+    game_time::erase_mob(smoke, true);
+
+    CHECK(!map::first_mob_at_pos(p0));
+}
+
+TEST_FIXTURE(BasicFixture, light_map_incremental)
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            const P p(x, y);
+
+            if (map::is_pos_inside_map(p, false))
+            {
+                map::put(new Floor(p));
+            }
+        }
+    }
+
+    const P p0(20, 10);
+
+    // Add a light source
+    light_srcs::begin_update();
+    light_srcs::add_moving(p0, LgtSize::fov);
+    light_srcs::end_update();
+
+    CHECK(map::cells[p0.x    ][p0.y].is_lit);
+    CHECK(map::cells[p0.x + 5][p0.y].is_lit);
+    CHECK(!map::cells[p0.x + 9][p0.y].is_lit);
+
+    // Block the light with a wall
+    map::put(new Wall(P(p0.x + 2, p0.y)));
+
+    light_srcs::begin_update();
+    light_srcs::add_moving(p0, LgtSize::fov);
+    light_srcs::end_update();
+
+    CHECK(map::cells[p0.x + 2][p0.y].is_lit);
+    CHECK(!map::cells[p0.x + 5][p0.y].is_lit);
+
+    // Move the light source
+    light_srcs::begin_update();
+    light_srcs::add_moving(p0 + P(0, 1), LgtSize::small);
+    light_srcs::end_update();
+
+    CHECK(map::cells[p0.x][p0.y].is_lit);
+    CHECK(map::cells[p0.x][p0.y + 2].is_lit);
+    CHECK(!map::cells[p0.x][p0.y - 1].is_lit);
+    CHECK(!map::cells[p0.x - 5][p0.y].is_lit);
+
+    // Remove the light source
+    light_srcs::begin_update();
+    light_srcs::end_update();
+
+    CHECK(!map::cells[p0.x][p0.y].is_lit);
+    CHECK(!map::cells[p0.x][p0.y + 2].is_lit);
+}
+
+TEST_FIXTURE(BasicFixture, light_map_registered_srcs)
+{
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            const P p(x, y);
+
+            if (map::is_pos_inside_map(p, false))
+            {
+                map::put(new Floor(p));
+            }
+        }
+    }
+
+    const P flare_pos(20, 10);
+
+    Mob* const flare = new LitFlare(flare_pos, 10);
+
+    game_time::add_mob(flare);
+
+    game_time::update_light_map();
+
+    CHECK(map::cells[flare_pos.x + 5][flare_pos.y].is_lit);
+
+    // Blocking the light should update the flare light
+    map::put(new Wall(P(flare_pos.x + 2, flare_pos.y)));
+
+    game_time::update_light_map();
+
+    CHECK(map::cells[flare_pos.x + 2][flare_pos.y].is_lit);
+    CHECK(!map::cells[flare_pos.x + 5][flare_pos.y].is_lit);
+
+    map::put(new Floor(P(flare_pos.x + 2, flare_pos.y)));
+
+    game_time::update_light_map();
+
+    CHECK(map::cells[flare_pos.x + 5][flare_pos.y].is_lit);
+
+    // Putting and removing a brazier
+    const P brazier_pos(60, 10);
+
+    map::put(new Brazier(brazier_pos));
+
+    game_time::update_light_map();
+
+    CHECK(map::cells[brazier_pos.x + 1][brazier_pos.y + 1].is_lit);
+    CHECK(!map::cells[brazier_pos.x + 2][brazier_pos.y].is_lit);
+
+    map::put(new Floor(brazier_pos));
+
+    game_time::update_light_map();
+
+    CHECK(!map::cells[brazier_pos.x + 1][brazier_pos.y + 1].is_lit);
+
+    // Removing the flare
+    game_time::erase_mob(flare, true);
+
+    game_time::update_light_map();
+
+    CHECK(!map::cells[flare_pos.x][flare_pos.y].is_lit);
+    CHECK(!map::cells[flare_pos.x + 5][flare_pos.y].is_lit);
+}
+
 TEST_FIXTURE(BasicFixture, throw_items)
 {
     // -----------------------------------------------------------------
@@ -612,7 +1012,7 @@ TEST_FIXTURE(BasicFixture, throw_items)
     map::put(new Floor(P(5, 7)));
     map::put(new Floor(P(5, 9)));
     map::put(new Floor(P(5, 10)));
-    map::player->pos = P(5, 10);
+    map::player->set_pos(P(5, 10));
     P tgt(5, 8);
     Item* item = item_factory::mk(ItemId::thr_knife);
     throwing::throw_item(*(map::player), tgt, *item);
@@ -775,7 +1175,7 @@ TEST_FIXTURE(BasicFixture, monster_stuck_in_spider_web)
 
         // Move the monster into the trap, and back again
         mon->aware_of_player_counter_ = 20000; // > 0 req. for triggering trap
-        mon->pos = pos_l;
+        mon->set_pos(pos_l);
         mon->move(Dir::right);
 
         CHECK(mon->pos == pos_r);
@@ -820,7 +1220,7 @@ TEST_FIXTURE(BasicFixture, using_inventory)
 {
     const P p(10, 10);
     map::put(new Floor(p));
-    map::player->pos = p;
+    map::player->set_pos(p);
 
     Inventory& inv = map::player->inv();
 
@@ -916,7 +1316,7 @@ TEST_FIXTURE(BasicFixture, using_inventory)
     CHECK(!body_slot.item);
 
     // Check that the item is on the ground
-    Cell& cell = map::cells[p.x][p.y];
+    Cell cell = map::cells[p.x][p.y];
     CHECK(cell.item);
 
     // Check that the properties are cleared
@@ -1102,7 +1502,7 @@ TEST_FIXTURE(BasicFixture, loading_game)
 
     const int player_max_hp_before_load = map::player->hp_max(true);
 
-    saving::load_game();
+    CHECK(saving::load_game());
 
     // Item data
     CHECK_EQUAL(true,  item_data::data[int(ItemId::scroll_telep)].is_tried);
@@ -1243,6 +1643,57 @@ TEST_FIXTURE(BasicFixture, loading_game)
     CHECK_EQUAL(0, game_time::turn_nr());
 }
 
+TEST_FIXTURE(BasicFixture, loading_corrupt_save)
+{
+    const std::string save_path = "res/data/save";
+
+    auto read_save_file = [&]()
+    {
+        std::ifstream file(save_path, std::ios::binary);
+
+        return std::vector<char>(std::istreambuf_iterator<char>(file),
+                                 std::istreambuf_iterator<char>());
+    };
+
+    auto write_save_file = [&](const std::vector<char>& bytes)
+    {
+        std::ofstream file(save_path, std::ios::trunc | std::ios::binary);
+
+        file.write(bytes.data(), bytes.size());
+    };
+
+    saving::save_game();
+
+    const std::vector<char> saved_bytes = read_save_file();
+
+    CHECK(saved_bytes.size() > 16);
+
+    // Flip a byte in the data (after the header)
+    std::vector<char> corrupt_bytes = saved_bytes;
+
+    corrupt_bytes[16 + ((corrupt_bytes.size() - 16) / 2)] ^= 0x5a;
+
+    write_save_file(corrupt_bytes);
+
+    // The header is still fine, but loading must be rejected
+    CHECK(saving::is_save_available());
+
+    CHECK(!saving::load_game());
+
+    // The save file must not be overwritten
+    CHECK(read_save_file() == corrupt_bytes);
+
+    // The original file can still be loaded (which also empties the file)
+    init::cleanup_session();
+    init::init_session();
+
+    write_save_file(saved_bytes);
+
+    CHECK(saving::load_game());
+
+    CHECK(!saving::is_save_available());
+}
+
 TEST_FIXTURE(BasicFixture, floodfilling)
 {
     bool blocked[map_w][map_h] = {};
@@ -1656,6 +2107,64 @@ TEST(find_choke_points)
                                             d);
 
     CHECK(!is_choke_point);
+
+    // -------------------------------------------------------------------------
+    // Finding all choke points at once should give the same result as testing
+    // each position
+    // -------------------------------------------------------------------------
+    bool candidates[map_w][map_h];
+
+    std::fill_n(*candidates, nr_map_cells, true);
+
+    for (int i = 0; i < 20; ++i)
+    {
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                blocked[x][y] =
+                    !map::is_pos_inside_map(P(x, y), false) ||
+                    rnd::percent(40);
+            }
+        }
+
+        std::vector<ChokePointData> expected;
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                ChokePointData choke_d;
+
+                if (!blocked[x][y] &&
+                    mapgen::is_choke_point(P(x, y), blocked, choke_d))
+                {
+                    expected.push_back(choke_d);
+                }
+            }
+        }
+
+        std::vector<ChokePointData> found;
+
+        mapgen::find_choke_points(blocked, candidates, found);
+
+        CHECK_EQUAL(expected.size(), found.size());
+
+        if (expected.size() != found.size())
+        {
+            continue;
+        }
+
+        for (size_t choke_idx = 0; choke_idx < found.size(); ++choke_idx)
+        {
+            const auto& e = expected[choke_idx];
+            const auto& f = found[choke_idx];
+
+            CHECK(e.p == f.p);
+            CHECK(e.sides[0] == f.sides[0]);
+            CHECK(e.sides[1] == f.sides[1]);
+        }
+    }
 }
 
 TEST_FIXTURE(BasicFixture, connect_rooms_with_corridor)
@@ -1752,6 +2261,385 @@ TEST_FIXTURE(BasicFixture, map_parse_cells_within_dist_of_others)
     CHECK_EQUAL(false, out[25][10]);
 }
 
+TEST_FIXTURE(BasicFixture, static_map_parsers)
+{
+    // The flag table shortcuts should agree with the feature objects,
+    // including doors which depend on their state
+    map::put(new Wall(P(10, 5)));
+    map::put(new RubbleHigh(P(11, 5)));
+
+    Door* const door_closed = new Door(P(12, 5));
+    Door* const door_open = new Door(P(13, 5));
+
+    map::put(door_closed);
+    map::put(door_open);
+
+    door_open->open(nullptr);
+
+    bool blocks_los[map_w][map_h];
+    bool blocks_move[map_w][map_h];
+    MapBitset blocks_projectiles;
+
+    map_parsers::BlocksLos().run(blocks_los);
+    map_parsers::BlocksMoveCommon(ParseActors::no).run(blocks_move);
+    map_parsers::BlocksProjectiles().run(blocks_projectiles);
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            const P p(x, y);
+
+            const Rigid* const r = map::cells[x][y].rigid;
+
+            const bool is_edge = !map::is_pos_inside_map(p, false);
+
+            CHECK_EQUAL(is_edge || !r->is_los_passable(),
+                        blocks_los[x][y]);
+
+            CHECK_EQUAL(is_edge || !r->can_move_common(),
+                        blocks_move[x][y]);
+
+            CHECK_EQUAL(is_edge || !r->is_projectile_passable(),
+                        blocks_projectiles.at(p));
+
+            CHECK_EQUAL(blocks_los[x][y],
+                        map_parsers::BlocksLos().cell(p));
+        }
+    }
+
+    CHECK(blocks_los[10][5]);
+    CHECK(blocks_los[12][5]);
+    CHECK(!blocks_los[13][5]);
+    CHECK(blocks_move[12][5]);
+    CHECK(!blocks_move[13][5]);
+
+    // The per-cell terrain flags follow the door state
+    door_open->close(nullptr);
+
+    CHECK(map_parsers::BlocksLos().cell(P(13, 5)));
+    CHECK(map::terrain_blocks(P(13, 5), feature_flag::blocks_move_common));
+
+    door_closed->open(nullptr);
+
+    CHECK(!map_parsers::BlocksLos().cell(P(12, 5)));
+    CHECK(!map::terrain_blocks(P(12, 5), feature_flag::blocks_projectiles));
+
+    // Living actors only block movement if actors are parsed
+    CHECK(!map_parsers::BlocksMoveCommon(ParseActors::no).cell(P(1, 1)));
+    CHECK(map_parsers::BlocksMoveCommon(ParseActors::yes).cell(P(1, 1)));
+}
+
+TEST(map_bitset_same_result_as_bool_array)
+{
+    bool in[map_w][map_h] = {};
+
+    in[0][0]            = true;
+    in[20][10]          = true;
+    in[map_w - 1][5]    = true;
+    in[40][map_h - 1]   = true;
+
+    MapBitset bits(in);
+
+    CHECK_EQUAL(4, bits.count());
+    CHECK(bits.at(P(20, 10)));
+    CHECK(!bits.at(P(21, 10)));
+
+    // Expanding should give the same result as the bool array version
+    for (int dist = 0; dist <= 3; ++dist)
+    {
+        bool expanded[map_w][map_h];
+
+        map_parsers::expand(in, expanded, dist);
+
+        const MapBitset expanded_bits = bits.expanded(dist);
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                const P p(x, y);
+
+                const bool is_in_range =
+                    king_dist(p, P(0, 0))               <= dist ||
+                    king_dist(p, P(20, 10))             <= dist ||
+                    king_dist(p, P(map_w - 1, 5))       <= dist ||
+                    king_dist(p, P(40, map_h - 1))      <= dist;
+
+                CHECK_EQUAL(is_in_range, expanded[x][y]);
+                CHECK_EQUAL(is_in_range, expanded_bits.at(p));
+            }
+        }
+    }
+
+    // Inverting should never set cells outside the map height
+    const MapBitset inv = ~bits;
+
+    CHECK_EQUAL(map_w * map_h - 4, inv.count());
+    CHECK((inv | bits) == ~MapBitset());
+    CHECK(!(inv & bits).any());
+
+    // Only the cells within the area should be read
+    const MapBitset area_bits(in, R(15, 5, 25, 15));
+
+    CHECK_EQUAL(1, area_bits.count());
+    CHECK(area_bits.at(P(20, 10)));
+
+    // Expanding within an area should only write the area, and the result
+    // there should be the same as when expanding the whole map
+    bool expanded_area[map_w][map_h] = {};
+
+    map_parsers::expand(in, expanded_area, R(19, 9, 21, 11));
+
+    for (int x = 0; x < map_w; ++x)
+    {
+        for (int y = 0; y < map_h; ++y)
+        {
+            const bool is_in_area = (x >= 19 && x <= 21 && y >= 9 && y <= 11);
+
+            CHECK_EQUAL(is_in_area, expanded_area[x][y]);
+        }
+    }
+}
+
+TEST(flood_workspace)
+{
+    bool blocked[map_w][map_h] = {};
+
+    // A wall with an opening at the bottom
+    for (int y = 1; y < 9; ++y)
+    {
+        blocked[20][y] = true;
+    }
+
+    FloodWorkspace flood;
+
+    const P origin(18, 5);
+
+    flood.run(origin, blocked);
+
+    CHECK(flood.is_reached(origin));
+    CHECK_EQUAL(0, flood.dist(origin));
+    CHECK_EQUAL(1, flood.dist(P(19, 5)));
+    CHECK_EQUAL(0, flood.dist(P(20, 5)));
+    CHECK(!flood.is_reached(P(20, 5)));
+
+    // Around the wall
+    CHECK_EQUAL(8, flood.dist(P(21, 5)));
+
+    // The map edge is never reached
+    CHECK(!flood.is_reached(P(0, 5)));
+
+    // Limited distance - the previous fill should not leave anything behind
+    flood.run(origin, blocked, 3);
+
+    CHECK_EQUAL(3, flood.dist(P(15, 5)));
+    CHECK(!flood.is_reached(P(14, 5)));
+    CHECK(!flood.is_reached(P(21, 5)));
+
+    // Limited area
+    flood.run(origin, blocked, INT_MAX, true, R(10, 1, 19, 10));
+
+    CHECK(flood.is_reached(P(10, 10)));
+    CHECK(!flood.is_reached(P(10, 11)));
+    CHECK(!flood.is_reached(P(21, 5)));
+
+    // Pathfinding
+    std::vector<P> path;
+
+    flood.pathfind(origin, P(21, 5), blocked, path, true, false);
+
+    CHECK_EQUAL(8, int(path.size()));
+    CHECK(path.front() == P(21, 5));
+    CHECK(is_pos_adj(path.back(), origin, false));
+
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        CHECK(is_pos_adj(path[i - 1], path[i], false));
+        CHECK(!blocked[path[i].x][path[i].y]);
+    }
+}
+
+TEST_FIXTURE(BasicFixture, anim_script_headless)
+{
+    // Without any io, nothing should be recorded (or played)
+    AnimScript script;
+
+    CHECK(!script.is_recording());
+
+    script.add_frame(100);
+    script.add_cell(P(5, 5), TileId::blast1, '*', clr_yellow);
+    script.add_blast({P(5, 5), P(6, 6)}, clr_red_lgt, 100);
+
+    CHECK(script.is_empty());
+
+    anim::play(script);
+
+    // Explosions resolve instantly when headless
+    explosion::run(P(5, 5), ExplType::expl);
+}
+
+namespace
+{
+
+// The explosion reach as originally computed, by tracing the line to each cell
+std::vector< std::vector<P> > expl_reach_by_lines(const R& area,
+                                                  const P& origin,
+                                                  const ExplExclCenter excl,
+                                                  bool blocked[map_w][map_h])
+{
+    std::vector< std::vector<P> > out;
+
+    std::vector<P> line;
+
+    for (int y = area.p0.y; y <= area.p1.y; ++y)
+    {
+        for (int x = area.p0.x; x <= area.p1.x; ++x)
+        {
+            const P pos(x, y);
+
+            if (excl == ExplExclCenter::yes && pos == origin)
+            {
+                continue;
+            }
+
+            const int dist = king_dist(pos, origin);
+
+            bool is_reached = true;
+
+            if (dist > 1)
+            {
+                line_calc::calc_new_line(origin, pos, true, 999, false, line);
+
+                for (const P& p : line)
+                {
+                    if (blocked[p.x][p.y])
+                    {
+                        is_reached = false;
+                        break;
+                    }
+                }
+            }
+
+            if (is_reached)
+            {
+                if ((int)out.size() <= dist)
+                {
+                    out.resize(dist + 1);
+                }
+
+                out[dist].push_back(pos);
+            }
+        }
+    }
+
+    return out;
+}
+
+} // namespace
+
+TEST_FIXTURE(BasicFixture, explosion_cells_reached)
+{
+    bool blocked[map_w][map_h];
+
+    ExplReach reach;
+
+    // Same result as tracing lines, also for radii beyond the precomputed
+    // line masks
+    for (int i = 0; i < 2000; ++i)
+    {
+        const int blocked_pct = rnd::range(0, 60);
+
+        for (int x = 0; x < map_w; ++x)
+        {
+            for (int y = 0; y < map_h; ++y)
+            {
+                blocked[x][y] = rnd::percent(blocked_pct);
+            }
+        }
+
+        const P origin(rnd::range(1, map_w - 2), rnd::range(1, map_h - 2));
+
+        const R area = explosion::explosion_area(origin, rnd::range(1, 7));
+
+        const ExplExclCenter excl =
+            rnd::coin_toss() ? ExplExclCenter::yes : ExplExclCenter::no;
+
+        const auto expected = expl_reach_by_lines(area, origin, excl, blocked);
+
+        explosion::cells_reached(area, origin, excl, blocked, reach);
+
+        CHECK_EQUAL((int)expected.size(), reach.nr_dists);
+
+        size_t idx = 0;
+
+        for (size_t dist = 0; dist < expected.size(); ++dist)
+        {
+            for (const P& p : expected[dist])
+            {
+                CHECK(idx < reach.cells.size());
+
+                if (idx < reach.cells.size())
+                {
+                    CHECK(reach.cells[idx].pos == p);
+                    CHECK_EQUAL((int)dist, reach.cells[idx].dist);
+                }
+
+                ++idx;
+            }
+        }
+
+        CHECK_EQUAL(idx, reach.cells.size());
+    }
+}
+
+TEST_FIXTURE(BasicFixture, find_path_to_player_never_steps_back)
+{
+    // An L-shaped corridor, with the player around the corner:
+    //
+    // ..MA.....
+    //         .
+    //         .
+    //         @
+    //
+    for (int x = 2; x <= 10; ++x)
+    {
+        map::put(new Floor(P(x, 5)));
+    }
+
+    for (int y = 6; y <= 12; ++y)
+    {
+        map::put(new Floor(P(10, y)));
+    }
+
+    map::player->set_pos(P(10, 12));
+
+    Mon* const mon =
+        static_cast<Mon*>(actor_factory::mk(ActorId::zombie, P(4, 5)));
+
+    mon->aware_of_player_counter_ = 10;
+
+    std::vector<P> path;
+
+    // Free corridor, the first step is towards the player
+    ai::info::find_path_to_player(*mon, path);
+
+    CHECK(!path.empty());
+
+    if (!path.empty())
+    {
+        CHECK(path.back() == P(5, 5));
+    }
+
+    // An ally blocks the corridor - the monster must not step away from the
+    // player, and there is no detour
+    actor_factory::mk(ActorId::zombie, P(5, 5));
+
+    ai::info::find_path_to_player(*mon, path);
+
+    CHECK(path.empty());
+}
+
 // -----------------------------------------------------------------------------
 // Some code exercise
 // -----------------------------------------------------------------------------